@@ -34,47 +34,27 @@ static inline void ring_buf_clamp(ring_buf_size_t *clamp,
     *clamp = limit;
 }
 
-/*!
- * \brief Head index of a zone.
- * \details Used as the wrap size when claiming. The wrap size equals the head
- * relative to the base.
- */
-static inline ring_buf_size_t
-ring_buf_zone_head(const struct ring_buf_zone *zone) {
-  return zone->head - zone->base;
-}
-
-static inline ring_buf_size_t
-ring_buf_zone_tail(const struct ring_buf_zone *zone) {
-  return zone->tail - zone->base;
-}
-
 static inline ring_buf_size_t
 ring_buf_zone_claim(const struct ring_buf_zone *zone) {
   return zone->head - zone->tail;
 }
 
-void ring_buf_zone_reset(struct ring_buf_zone *zone, ring_buf_ptrdiff_t base) {
-  zone->base = zone->head = zone->tail = base;
+void ring_buf_zone_reset(struct ring_buf_zone *zone, ring_buf_index_t index) {
+  zone->head = zone->tail = index;
 }
 
-void ring_buf_reset(struct ring_buf *buf, ring_buf_ptrdiff_t base) {
-  ring_buf_zone_reset(&buf->put, base);
-  ring_buf_zone_reset(&buf->get, base);
+void ring_buf_reset(struct ring_buf *buf, ring_buf_index_t index) {
+  ring_buf_zone_reset(&buf->put, index);
+  ring_buf_zone_reset(&buf->get, index);
 }
 
 ring_buf_size_t ring_buf_put_claim(struct ring_buf *buf, void **space,
                                    ring_buf_size_t size) {
-  ring_buf_ptrdiff_t base = buf->put.base;
-  ring_buf_size_t head = ring_buf_zone_head(&buf->put);
-  if (head >= buf->size) {
-    base += buf->size;
-    head -= buf->size;
-  }
+  ring_buf_size_t head = ring_buf_offset(buf, buf->put.head);
   ring_buf_clamp(&size, buf->size - head);
   ring_buf_clamp(&size, ring_buf_free_space(buf));
   if (space)
-    *space = (uint8_t *)buf->space + (buf->put.head - base);
+    *space = (uint8_t *)buf->space + head;
   buf->put.head += size;
   return size;
 }
@@ -84,23 +64,16 @@ int ring_buf_put_ack(struct ring_buf *buf, ring_buf_size_t size) {
   if (size > claim)
     return -EINVAL;
   buf->put.head = (buf->put.tail += size);
-  if (ring_buf_zone_tail(&buf->put) >= buf->size)
-    buf->put.base += buf->size;
   return 0;
 }
 
 ring_buf_size_t ring_buf_get_claim(struct ring_buf *buf, void **space,
                                    ring_buf_size_t size) {
-  ring_buf_ptrdiff_t base = buf->get.base;
-  ring_buf_size_t head = ring_buf_zone_head(&buf->get);
-  if (head >= buf->size) {
-    base += buf->size;
-    head -= buf->size;
-  }
+  ring_buf_size_t head = ring_buf_offset(buf, buf->get.head);
   ring_buf_clamp(&size, buf->size - head);
   ring_buf_clamp(&size, ring_buf_used_space(buf));
   if (space)
-    *space = (uint8_t *)buf->space + (buf->get.head - base);
+    *space = (uint8_t *)buf->space + head;
   buf->get.head += size;
   return size;
 }
@@ -110,11 +83,49 @@ int ring_buf_get_ack(struct ring_buf *buf, ring_buf_size_t size) {
   if (size > claim)
     return -EINVAL;
   buf->get.head = (buf->get.tail += size);
-  if (ring_buf_zone_tail(&buf->get) >= buf->size)
-    buf->get.base += buf->size;
   return 0;
 }
 
+/*!
+ * \brief Padding that aligns a record at a zone's head.
+ * \details Both zones reach the same offsets in the same order, hence put and
+ * get pad identically. Answers the buffer size or more if the record cannot
+ * fit anywhere.
+ */
+static ring_buf_size_t ring_buf_align_pad(const struct ring_buf *buf,
+                                          const struct ring_buf_zone *zone,
+                                          ring_buf_size_t size,
+                                          ring_buf_size_t align) {
+  ring_buf_size_t offset = ring_buf_offset(buf, zone->head);
+  ring_buf_size_t start = -(uintptr_t)buf->space & (align - 1U);
+  ring_buf_size_t pad = -((uintptr_t)buf->space + offset) & (align - 1U);
+  if (start + size > buf->size)
+    return buf->size;
+  if (pad + size > buf->size - offset)
+    pad = buf->size - offset + start;
+  return pad;
+}
+
+ring_buf_size_t ring_buf_put_claim_aligned(struct ring_buf *buf, void **space,
+                                           ring_buf_size_t size,
+                                           ring_buf_size_t align) {
+  ring_buf_size_t pad = ring_buf_align_pad(buf, &buf->put, size, align);
+  if (pad + size > ring_buf_free_space(buf))
+    return 0U;
+  buf->put.head += pad;
+  return pad + ring_buf_put_claim(buf, space, size);
+}
+
+ring_buf_size_t ring_buf_get_claim_aligned(struct ring_buf *buf, void **space,
+                                           ring_buf_size_t size,
+                                           ring_buf_size_t align) {
+  ring_buf_size_t pad = ring_buf_align_pad(buf, &buf->get, size, align);
+  if (pad + size > ring_buf_used_space(buf))
+    return 0U;
+  buf->get.head += pad;
+  return pad + ring_buf_get_claim(buf, space, size);
+}
+
 ring_buf_size_t ring_buf_put(struct ring_buf *buf, const void *data,
                              ring_buf_size_t size) {
   ring_buf_size_t ack = 0U, claim;
@@ -161,3 +172,90 @@ int ring_buf_get_all(struct ring_buf *buf, void *data, ring_buf_size_t size) {
   (void)ring_buf_get_ack(buf, ack);
   return err;
 }
+
+ring_buf_size_t ring_buf_put_records(struct ring_buf *buf, const void *data,
+                                     ring_buf_size_t size,
+                                     ring_buf_size_t count) {
+  if (size == 0U)
+    return 0U;
+  ring_buf_clamp(&count, ring_buf_free_space(buf) / size);
+  (void)ring_buf_put_ack(buf, ring_buf_put(buf, data, count * size));
+  return count;
+}
+
+ring_buf_size_t ring_buf_get_records(struct ring_buf *buf, void *data,
+                                     ring_buf_size_t size,
+                                     ring_buf_size_t count) {
+  if (size == 0U)
+    return 0U;
+  ring_buf_clamp(&count, ring_buf_used_space(buf) / size);
+  (void)ring_buf_get_ack(buf, ring_buf_get(buf, data, count * size));
+  return count;
+}
+
+static ring_buf_size_t ring_buf_spans_size(const struct ring_buf_span *spans,
+                                           ring_buf_size_t count) {
+  ring_buf_size_t size = 0U;
+  while (count--)
+    size += spans++->size;
+  return size;
+}
+
+ring_buf_size_t ring_buf_putv(struct ring_buf *buf,
+                              const struct ring_buf_span *spans,
+                              ring_buf_size_t count) {
+  ring_buf_size_t size = ring_buf_spans_size(spans, count), ack = 0U, claim,
+                  offset = 0U;
+  void *space;
+  while (ack < size && (claim = ring_buf_put_claim(buf, &space, size - ack))) {
+    for (ring_buf_size_t copy, at = 0U; at < claim; at += copy) {
+      copy = spans->size - offset;
+      ring_buf_clamp(&copy, claim - at);
+      (void)memcpy((uint8_t *)space + at,
+                   (const uint8_t *)spans->space + offset, copy);
+      if ((offset += copy) == spans->size) {
+        spans++;
+        offset = 0U;
+      }
+    }
+    ack += claim;
+  }
+  return ack;
+}
+
+ring_buf_size_t ring_buf_getv(struct ring_buf *buf,
+                              const struct ring_buf_span *spans,
+                              ring_buf_size_t count) {
+  ring_buf_size_t size = ring_buf_spans_size(spans, count), ack = 0U, claim,
+                  offset = 0U;
+  void *space;
+  while (ack < size && (claim = ring_buf_get_claim(buf, &space, size - ack))) {
+    for (ring_buf_size_t copy, at = 0U; at < claim; at += copy) {
+      copy = spans->size - offset;
+      ring_buf_clamp(&copy, claim - at);
+      if (spans->space)
+        (void)memcpy((uint8_t *)spans->space + offset, (uint8_t *)space + at,
+                     copy);
+      if ((offset += copy) == spans->size) {
+        spans++;
+        offset = 0U;
+      }
+    }
+    ack += claim;
+  }
+  return ack;
+}
+
+int ring_buf_putv_all(struct ring_buf *buf, const struct ring_buf_span *spans,
+                      ring_buf_size_t count) {
+  if (ring_buf_spans_size(spans, count) > ring_buf_free_space(buf))
+    return -EMSGSIZE;
+  return ring_buf_put_ack(buf, ring_buf_putv(buf, spans, count));
+}
+
+int ring_buf_getv_all(struct ring_buf *buf, const struct ring_buf_span *spans,
+                      ring_buf_size_t count) {
+  if (ring_buf_spans_size(spans, count) > ring_buf_used_space(buf))
+    return -EAGAIN;
+  return ring_buf_get_ack(buf, ring_buf_getv(buf, spans, count));
+}
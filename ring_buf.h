@@ -33,9 +33,19 @@ extern "C" {
 #include <errno.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 typedef ptrdiff_t ring_buf_ptrdiff_t;
 
+/*!
+ * \brief Free-running byte index.
+ * \details Counts bytes from reset. At 64 bits, an index increasing by ten
+ * gigabytes per second takes nearly sixty years to wrap. Unsigned arithmetic
+ * keeps differences correct even then, and power-of-two buffer sizes keep
+ * offsets continuous across the wrap.
+ */
+typedef uint64_t ring_buf_index_t;
+
 typedef size_t ring_buf_size_t;
 
 #define RING_BUF_SIZE_MAX ((ring_buf_size_t)PTRDIFF_MIN)
@@ -47,10 +57,13 @@ typedef size_t ring_buf_size_t;
  */
 
 /*!
- * \details This structure needs to exist within the header.
+ * \details This structure needs to exist within the header. Heads and tails
+ * are free-running byte indices that double as stream offsets: the put zone's
+ * tail counts all the bytes ever put and the get zone's tail all the bytes
+ * ever got, since reset. Only pointers reduce them modulo the buffer size.
  */
 struct ring_buf_zone {
-  ring_buf_ptrdiff_t base, head, tail;
+  ring_buf_index_t head, tail;
 };
 
 /*!
@@ -72,6 +85,16 @@ struct ring_buf {
   struct ring_buf_zone put, get;
 };
 
+/*!
+ * \brief Span of contiguous buffer space.
+ * \details Zero-copy views of ring buffer contents comprise one or two spans,
+ * two whenever the contents wrap around the end of the buffer space.
+ */
+struct ring_buf_span {
+  void *space;
+  ring_buf_size_t size;
+};
+
 static inline ring_buf_size_t ring_buf_used_space(const struct ring_buf *buf) {
   return buf->put.tail - buf->get.head;
 }
@@ -88,7 +111,22 @@ static inline bool ring_buf_is_full(const struct ring_buf *buf) {
   return ring_buf_free_space(buf) == 0U;
 }
 
-void ring_buf_reset(struct ring_buf *buf, ring_buf_ptrdiff_t base);
+/*!
+ * \brief Offset of an index within the buffer space.
+ * \details Masks rather than divides when the buffer size is a power of two.
+ */
+static inline ring_buf_size_t ring_buf_offset(const struct ring_buf *buf,
+                                              ring_buf_index_t index) {
+  if ((buf->size & (buf->size - 1U)) == 0U)
+    return (ring_buf_size_t)(index & (buf->size - 1U));
+  return (ring_buf_size_t)(index % buf->size);
+}
+
+/*!
+ * \brief Empties a ring buffer.
+ * \param index Starting index for both zones, typically zero.
+ */
+void ring_buf_reset(struct ring_buf *buf, ring_buf_index_t index);
 
 /*!
  * \defgroup ring_buf_contiguous Contiguous Ring Buffer Access
@@ -127,6 +165,36 @@ ring_buf_size_t ring_buf_get_claim(struct ring_buf *buf, void **space,
 
 int ring_buf_get_ack(struct ring_buf *buf, ring_buf_size_t size);
 
+/*!
+ * \brief Claims aligned contiguous space for putting a record.
+ * \details Pads the put head so that the claimed space starts at an address
+ * aligned to \c align bytes. Pads to the end of the buffer space and wraps
+ * if the record would not otherwise fit contiguously. Claims all or nothing.
+ *
+ * The padding belongs to the claim: acknowledge the answered size, padding
+ * included. Gets must claim the same records with the same sizes and
+ * alignment using \c ring_buf_get_claim_aligned, which skips the same
+ * padding.
+ * \param space Address of the aligned record space on success.
+ * \param size Size of the record in bytes.
+ * \param align Alignment in bytes, a power of two.
+ * \returns Number of bytes claimed including padding, or zero if the record
+ * does not fit.
+ */
+ring_buf_size_t ring_buf_put_claim_aligned(struct ring_buf *buf, void **space,
+                                           ring_buf_size_t size,
+                                           ring_buf_size_t align);
+
+/*!
+ * \brief Claims an aligned record for getting.
+ * \details Skips the padding put by \c ring_buf_put_claim_aligned.
+ * \returns Number of bytes claimed including padding, or zero if the buffer
+ * does not yet hold the record.
+ */
+ring_buf_size_t ring_buf_get_claim_aligned(struct ring_buf *buf, void **space,
+                                           ring_buf_size_t size,
+                                           ring_buf_size_t align);
+
 /*!
  * \}
  */
@@ -171,6 +239,73 @@ int ring_buf_put_all(struct ring_buf *buf, const void *data,
  */
 int ring_buf_get_all(struct ring_buf *buf, void *data, ring_buf_size_t size);
 
+/*!
+ * \brief Gathers bytes from spans into the ring buffer.
+ * \details Streams the spans in order through at most two contiguous claims,
+ * one on either side of the wrap. The return value may be less than the
+ * spans' total size if the buffer runs out of free space.
+ * \note Does \e not automatically acknowledge the space.
+ * \param spans Array of source spans.
+ * \param count Number of spans.
+ * \returns Buffer space to acknowledge in bytes.
+ */
+ring_buf_size_t ring_buf_putv(struct ring_buf *buf,
+                              const struct ring_buf_span *spans,
+                              ring_buf_size_t count);
+
+/*!
+ * \brief Scatters bytes from the ring buffer into spans.
+ * \details Spans with a \c NULL space discard their bytes.
+ * \note Does \e not automatically acknowledge the space.
+ * \returns Number of bytes to acknowledge.
+ */
+ring_buf_size_t ring_buf_getv(struct ring_buf *buf,
+                              const struct ring_buf_span *spans,
+                              ring_buf_size_t count);
+
+/*!
+ * \brief Gathers all or none.
+ * \details Checks the free space before copying anything.
+ * \retval 0 on success, acknowledged.
+ * \retval -EMSGSIZE if the spans' total size exceeds the free space.
+ */
+int ring_buf_putv_all(struct ring_buf *buf, const struct ring_buf_span *spans,
+                      ring_buf_size_t count);
+
+/*!
+ * \brief Scatters all or none.
+ * \retval 0 on success, acknowledged.
+ * \retval -EAGAIN if the spans' total size exceeds the used space.
+ */
+int ring_buf_getv_all(struct ring_buf *buf, const struct ring_buf_span *spans,
+                      ring_buf_size_t count);
+
+/*!
+ * \brief Puts whole fixed-size records.
+ * \details Works out up front how many whole records fit, copies exactly those
+ * and acknowledges them. Never copies part of a record.
+ * \param data Address of the records.
+ * \param size Size of each record in bytes.
+ * \param count Number of records to put.
+ * \returns Number of records put.
+ */
+ring_buf_size_t ring_buf_put_records(struct ring_buf *buf, const void *data,
+                                     ring_buf_size_t size,
+                                     ring_buf_size_t count);
+
+/*!
+ * \brief Gets whole fixed-size records.
+ * \details Works out up front how many whole records the buffer holds, copies
+ * exactly those and acknowledges them.
+ * \param data Address of the copied records, or \c NULL to discard them.
+ * \param size Size of each record in bytes.
+ * \param count Maximum number of records to get.
+ * \returns Number of records got.
+ */
+ring_buf_size_t ring_buf_get_records(struct ring_buf *buf, void *data,
+                                     ring_buf_size_t size,
+                                     ring_buf_size_t count);
+
 /*!
  * \}
  */
@@ -180,7 +315,9 @@ int ring_buf_get_all(struct ring_buf *buf, void *data, ring_buf_size_t size);
 #define RING_BUF_DEFINE(_name_, _size_)                                        \
   static uint8_t _ring_buf_space_##_name_[_size_];                             \
   static struct ring_buf _name_ = {.space = _ring_buf_space_##_name_,          \
-                                   .size = _size_}
+                                   .size = _size_,                             \
+                                   .put = {0U, 0U},                            \
+                                   .get = {0U, 0U}}
 
 /*!
  * \}
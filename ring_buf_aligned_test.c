@@ -0,0 +1,67 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "ring_buf.h"
+
+#define ALIGN 16U
+
+static int aligned(const void *space) {
+  return ((uintptr_t)space & (ALIGN - 1U)) == 0U;
+}
+
+int ring_buf_aligned_test(int argc, char **argv) {
+  /*
+   * Misalign the buffer space by one byte so that both the start and the
+   * wrapping need padding.
+   */
+  static uint8_t space[128U + ALIGN];
+  struct ring_buf buf = {
+      .space = space + (ALIGN - ((uintptr_t)space & (ALIGN - 1U))) + 1U,
+      .size = 127U};
+
+  /*
+   * A record larger than the space after aligning its start never fits.
+   */
+  void *put, *get;
+  assert(ring_buf_put_claim_aligned(&buf, &put, 124U, ALIGN) == 0U);
+  assert(ring_buf_used_space(&buf) == 0U);
+
+  /*
+   * Put and get records of 24 bytes repeatedly; the records wrap around the
+   * buffer space many times over.
+   */
+  uint32_t next = 0U, expect = 0U;
+  for (int round = 0; round < 100; round++) {
+    ring_buf_size_t claimed;
+    while ((claimed = ring_buf_put_claim_aligned(&buf, &put, 24U, ALIGN))) {
+      assert(aligned(put));
+      assert(claimed >= 24U && claimed - 24U < 24U + ALIGN);
+      *(uint32_t *)put = next++;
+      assert(ring_buf_put_ack(&buf, claimed) == 0);
+    }
+    while ((claimed = ring_buf_get_claim_aligned(&buf, &get, 24U, ALIGN))) {
+      assert(aligned(get));
+      assert(*(uint32_t *)get == expect++);
+      assert(ring_buf_get_ack(&buf, claimed) == 0);
+      if (expect & 1U)
+        break;
+    }
+  }
+  assert(next > 100U && expect > 100U);
+
+  /*
+   * Passive iteration over aligned records, then rewind.
+   */
+  ring_buf_size_t used = ring_buf_used_space(&buf);
+  uint32_t count = 0U;
+  while (ring_buf_get_claim_aligned(&buf, &get, 24U, ALIGN)) {
+    assert(aligned(get));
+    assert(*(uint32_t *)get == expect + count++);
+  }
+  assert(count == next - expect);
+  assert(ring_buf_get_ack(&buf, 0U) == 0);
+  assert(ring_buf_used_space(&buf) == used);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,288 @@
+/*!
+ * \file ring_buf_atomic.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf.h"
+
+/*!
+ * \defgroup ring_buf_atomic Ring Buffer Atomics
+ * \ingroup ring_buf_atomic
+ * \brief Minimal portable atomic operations.
+ * \details The ring buffer core stays free of atomics. Modules that share ring
+ * buffers across threads or with signal handlers use these operations on
+ * pointer-sized integers. Loads acquire, stores release; read-modify-write
+ * operations and the fence are sequentially consistent.
+ *
+ * Index operations load and store free-running ring buffer indices, 64 bits
+ * wide even on 32-bit targets. Space operations apply them to a ring buffer
+ * shared between threads. The 32-bit operations suit event words that
+ * operating systems wait on, futexes for example.
+ *
+ * Views let either side of a single-producer, single-consumer ring buffer
+ * use the plain ring buffer functions without racing the other side.
+ * Acquiring a view copies the caller's own zone and acquires the other
+ * side's tail, once. Putting into or getting from the view then reads
+ * nothing that the other side writes. Releasing the view publishes the
+ * caller's tail, storing it with release semantics after the bytes or space
+ * it covers.
+ *
+ * GCC and Clang use their built-in atomics. Microsoft's compiler uses
+ * interlocked intrinsics throughout, since its \c volatile semantics vary by
+ * target architecture.
+ * \{
+ */
+
+typedef ring_buf_ptrdiff_t ring_buf_atomic_t;
+
+#if defined(__GNUC__) || defined(__clang__)
+
+static inline ring_buf_atomic_t
+ring_buf_atomic_load(const volatile ring_buf_atomic_t *atomic) {
+  return __atomic_load_n(atomic, __ATOMIC_ACQUIRE);
+}
+
+static inline void ring_buf_atomic_store(volatile ring_buf_atomic_t *atomic,
+                                         ring_buf_atomic_t value) {
+  __atomic_store_n(atomic, value, __ATOMIC_RELEASE);
+}
+
+static inline ring_buf_atomic_t
+ring_buf_atomic_fetch_add(volatile ring_buf_atomic_t *atomic,
+                          ring_buf_atomic_t value) {
+  return __atomic_fetch_add(atomic, value, __ATOMIC_SEQ_CST);
+}
+
+static inline ring_buf_atomic_t
+ring_buf_atomic_exchange(volatile ring_buf_atomic_t *atomic,
+                         ring_buf_atomic_t value) {
+  return __atomic_exchange_n(atomic, value, __ATOMIC_SEQ_CST);
+}
+
+static inline bool
+ring_buf_atomic_compare_exchange(volatile ring_buf_atomic_t *atomic,
+                                 ring_buf_atomic_t *expected,
+                                 ring_buf_atomic_t desired) {
+  return __atomic_compare_exchange_n(atomic, expected, desired, false,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE);
+}
+
+static inline void ring_buf_atomic_fence(void) {
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t
+ring_buf_atomic32_load(const volatile uint32_t *atomic) {
+  return __atomic_load_n(atomic, __ATOMIC_ACQUIRE);
+}
+
+static inline uint32_t ring_buf_atomic32_fetch_add(volatile uint32_t *atomic,
+                                                   uint32_t value) {
+  return __atomic_fetch_add(atomic, value, __ATOMIC_SEQ_CST);
+}
+
+static inline ring_buf_index_t
+ring_buf_atomic_index_load(const volatile ring_buf_index_t *index) {
+  return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+}
+
+static inline void
+ring_buf_atomic_index_store(volatile ring_buf_index_t *index,
+                            ring_buf_index_t value) {
+  __atomic_store_n(index, value, __ATOMIC_RELEASE);
+}
+
+#elif defined(_MSC_VER)
+
+#include <intrin.h>
+
+#ifdef _WIN64
+#define RING_BUF_ATOMIC_INTERLOCKED(_name_) _name_##64
+typedef __int64 ring_buf_atomic_interlocked_t;
+#else
+#define RING_BUF_ATOMIC_INTERLOCKED(_name_) _name_
+typedef long ring_buf_atomic_interlocked_t;
+#endif
+
+#define RING_BUF_ATOMIC_CAST(_atomic_)                                         \
+  ((volatile ring_buf_atomic_interlocked_t *)(_atomic_))
+
+static inline ring_buf_atomic_t
+ring_buf_atomic_load(const volatile ring_buf_atomic_t *atomic) {
+  return (ring_buf_atomic_t)RING_BUF_ATOMIC_INTERLOCKED(_InterlockedOr)(
+      RING_BUF_ATOMIC_CAST(atomic), 0);
+}
+
+static inline void ring_buf_atomic_store(volatile ring_buf_atomic_t *atomic,
+                                         ring_buf_atomic_t value) {
+  (void)RING_BUF_ATOMIC_INTERLOCKED(_InterlockedExchange)(
+      RING_BUF_ATOMIC_CAST(atomic), value);
+}
+
+static inline ring_buf_atomic_t
+ring_buf_atomic_fetch_add(volatile ring_buf_atomic_t *atomic,
+                          ring_buf_atomic_t value) {
+  return (ring_buf_atomic_t)RING_BUF_ATOMIC_INTERLOCKED(
+      _InterlockedExchangeAdd)(RING_BUF_ATOMIC_CAST(atomic), value);
+}
+
+static inline ring_buf_atomic_t
+ring_buf_atomic_exchange(volatile ring_buf_atomic_t *atomic,
+                         ring_buf_atomic_t value) {
+  return (ring_buf_atomic_t)RING_BUF_ATOMIC_INTERLOCKED(_InterlockedExchange)(
+      RING_BUF_ATOMIC_CAST(atomic), value);
+}
+
+static inline bool
+ring_buf_atomic_compare_exchange(volatile ring_buf_atomic_t *atomic,
+                                 ring_buf_atomic_t *expected,
+                                 ring_buf_atomic_t desired) {
+  ring_buf_atomic_t actual = (ring_buf_atomic_t)RING_BUF_ATOMIC_INTERLOCKED(
+      _InterlockedCompareExchange)(RING_BUF_ATOMIC_CAST(atomic), desired,
+                                   *expected);
+  if (actual == *expected)
+    return true;
+  *expected = actual;
+  return false;
+}
+
+static inline void ring_buf_atomic_fence(void) {
+  volatile ring_buf_atomic_t fence = 0;
+  (void)RING_BUF_ATOMIC_INTERLOCKED(_InterlockedOr)(
+      RING_BUF_ATOMIC_CAST(&fence), 0);
+}
+
+static inline uint32_t
+ring_buf_atomic32_load(const volatile uint32_t *atomic) {
+  return (uint32_t)_InterlockedOr((volatile long *)atomic, 0);
+}
+
+static inline uint32_t ring_buf_atomic32_fetch_add(volatile uint32_t *atomic,
+                                                   uint32_t value) {
+  return (uint32_t)_InterlockedExchangeAdd((volatile long *)atomic,
+                                           (long)value);
+}
+
+/*
+ * The 64-bit compare-exchange exists on 32-bit as well as 64-bit targets.
+ */
+static inline ring_buf_index_t
+ring_buf_atomic_index_load(const volatile ring_buf_index_t *index) {
+  return (ring_buf_index_t)_InterlockedCompareExchange64(
+      (volatile __int64 *)index, 0, 0);
+}
+
+static inline void
+ring_buf_atomic_index_store(volatile ring_buf_index_t *index,
+                            ring_buf_index_t value) {
+  __int64 expected = (__int64)ring_buf_atomic_index_load(index), actual;
+  while ((actual = _InterlockedCompareExchange64((volatile __int64 *)index,
+                                                 (__int64)value, expected)) !=
+         expected)
+    expected = actual;
+}
+
+#else
+#error "ring_buf_atomic.h: unsupported compiler"
+#endif
+
+/*!
+ * \brief Acquires the used space of a shared ring buffer.
+ * \details Loads both zones' tails, hence answers acknowledged bytes only.
+ * Any thread may call it. Loading the get tail first keeps the answer from
+ * going negative; the put tail may meanwhile run ahead, so the answer clamps
+ * at the buffer size.
+ */
+static inline ring_buf_size_t
+ring_buf_atomic_used_space(const struct ring_buf *buf) {
+  ring_buf_index_t tail = ring_buf_atomic_index_load(&buf->get.tail);
+  ring_buf_index_t used = ring_buf_atomic_index_load(&buf->put.tail) - tail;
+  return used < buf->size ? (ring_buf_size_t)used : buf->size;
+}
+
+/*!
+ * \brief Acquires the free space of a shared ring buffer.
+ */
+static inline ring_buf_size_t
+ring_buf_atomic_free_space(const struct ring_buf *buf) {
+  return buf->size - ring_buf_atomic_used_space(buf);
+}
+
+/*!
+ * \brief Acquires the producer's view of a shared ring buffer.
+ * \details Call from the producing thread only.
+ */
+static inline void ring_buf_atomic_put_acquire(struct ring_buf *view,
+                                               const struct ring_buf *buf) {
+  view->space = buf->space;
+  view->size = buf->size;
+  view->put = buf->put;
+  view->get.head = view->get.tail =
+      ring_buf_atomic_index_load(&buf->get.tail);
+}
+
+/*!
+ * \brief Releases the producer's view, publishing its acknowledged puts.
+ */
+static inline void ring_buf_atomic_put_release(struct ring_buf *buf,
+                                               const struct ring_buf *view) {
+  buf->put.head = view->put.head;
+  ring_buf_atomic_index_store(&buf->put.tail, view->put.tail);
+}
+
+/*!
+ * \brief Acquires the consumer's view of a shared ring buffer.
+ * \details Call from the consuming thread only.
+ */
+static inline void ring_buf_atomic_get_acquire(struct ring_buf *view,
+                                               const struct ring_buf *buf) {
+  view->space = buf->space;
+  view->size = buf->size;
+  view->put.head = view->put.tail =
+      ring_buf_atomic_index_load(&buf->put.tail);
+  view->get = buf->get;
+}
+
+/*!
+ * \brief Releases the consumer's view, publishing its acknowledged gets.
+ */
+static inline void ring_buf_atomic_get_release(struct ring_buf *buf,
+                                               const struct ring_buf *view) {
+  buf->get.head = view->get.head;
+  ring_buf_atomic_index_store(&buf->get.tail, view->get.tail);
+}
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,88 @@
+/*!
+ * \file ring_buf_batch.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_batch.h"
+
+void ring_buf_batch_init(struct ring_buf_batch *batch, struct ring_buf *buf,
+                         ring_buf_size_t max_bytes, unsigned max_count,
+                         uint32_t max_delay) {
+  batch->buf = buf;
+  batch->bytes = 0U;
+  batch->max_bytes = max_bytes;
+  batch->count = 0U;
+  batch->max_count = max_count;
+  batch->since = 0U;
+  batch->max_delay = max_delay;
+}
+
+ring_buf_size_t ring_buf_batch_put_claim(struct ring_buf_batch *batch,
+                                         void **space, ring_buf_size_t size) {
+  struct ring_buf *buf = batch->buf, view;
+  ring_buf_atomic_put_acquire(&view, buf);
+  size = ring_buf_put_claim(&view, space, size);
+  buf->put.head = view.put.head;
+  return size;
+}
+
+/*
+ * The pending bytes sit between the put zone's tail and head. Rewinding the
+ * head to the end of the pending bytes disclaims the unacknowledged remainder
+ * without publishing the tail.
+ */
+int ring_buf_batch_put_ack(struct ring_buf_batch *batch, ring_buf_size_t size,
+                           uint32_t now) {
+  struct ring_buf *buf = batch->buf;
+  ring_buf_size_t claim = buf->put.head - buf->put.tail - batch->bytes;
+  if (size > claim)
+    return -EINVAL;
+  if (batch->count++ == 0U)
+    batch->since = now;
+  batch->bytes += size;
+  buf->put.head = buf->put.tail + batch->bytes;
+  if (batch->bytes >= batch->max_bytes || batch->count >= batch->max_count ||
+      now - batch->since >= batch->max_delay)
+    ring_buf_batch_flush(batch);
+  return 0;
+}
+
+/*
+ * Stores the tail with release semantics: the consumer sees the batched bytes
+ * before it sees the tail that covers them.
+ */
+void ring_buf_batch_flush(struct ring_buf_batch *batch) {
+  struct ring_buf *buf = batch->buf;
+  buf->put.head = buf->put.tail + batch->bytes;
+  ring_buf_atomic_index_store(&buf->put.tail, buf->put.head);
+  batch->bytes = 0U;
+  batch->count = 0U;
+}
+
+bool ring_buf_batch_poll(struct ring_buf_batch *batch, uint32_t now) {
+  if (batch->count == 0U || now - batch->since < batch->max_delay)
+    return false;
+  ring_buf_batch_flush(batch);
+  return true;
+}
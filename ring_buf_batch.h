@@ -0,0 +1,119 @@
+/*!
+ * \file ring_buf_batch.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf_atomic.h"
+
+/*!
+ * \defgroup ring_buf_batch Ring Buffer Batched Acknowledgement
+ * \ingroup ring_buf_batch
+ * \brief Batches put acknowledgements.
+ * \details Every put acknowledgement publishes the put zone's tail. When
+ * producer and consumer run on different cores, each publication moves the
+ * tail's cache line across to the consumer. Batching accumulates
+ * acknowledgements locally and publishes them together: once the pending
+ * bytes or the number of pending acknowledgements reach a threshold, on an
+ * explicit flush, or once the oldest pending acknowledgement grows older than
+ * a latency bound.
+ *
+ * Time runs in caller-defined ticks from any monotonic clock; the batch only
+ * ever compares differences, so the tick counter may wrap. Pending bytes stay
+ * claimed. Subsequent claims continue after them and the consumer cannot see
+ * them until publication.
+ *
+ * Publication stores the put zone's tail with release semantics. A consumer
+ * on another thread acquires it, by getting through a consumer view or by
+ * polling the atomic used space, before reading the published bytes. A
+ * producer sharing the ring buffer with such a consumer claims through the
+ * batch, which acquires the consumer's tail.
+ * \{
+ */
+
+struct ring_buf_batch {
+  struct ring_buf *buf;
+  ring_buf_size_t bytes, max_bytes;
+  unsigned count, max_count;
+  uint32_t since, max_delay;
+};
+
+/*!
+ * \brief Initialises a put batch.
+ * \param max_bytes Publishes when pending bytes reach this many.
+ * \param max_count Publishes when pending acknowledgements reach this many.
+ * \param max_delay Publishes when the oldest pending acknowledgement reaches
+ * this age in ticks.
+ */
+void ring_buf_batch_init(struct ring_buf_batch *batch, struct ring_buf *buf,
+                         ring_buf_size_t max_bytes, unsigned max_count,
+                         uint32_t max_delay);
+
+/*!
+ * \brief Claims contiguous put space after the pending bytes.
+ * \details Like \c ring_buf_put_claim, but bounds the claim by the get
+ * zone's tail as acquired from the consumer's thread.
+ * \returns Number of bytes claimed.
+ */
+ring_buf_size_t ring_buf_batch_put_claim(struct ring_buf_batch *batch,
+                                         void **space, ring_buf_size_t size);
+
+/*!
+ * \brief Acknowledges claimed put space without necessarily publishing it.
+ * \details Like \c ring_buf_put_ack, disclaims any claimed space beyond the
+ * acknowledged bytes.
+ * \param size Number of bytes to acknowledge.
+ * \param now Current time in ticks.
+ * \retval 0 on success, whether published or not.
+ * \retval -EINVAL if \c size exceeds the claimed space beyond the pending
+ * bytes.
+ */
+int ring_buf_batch_put_ack(struct ring_buf_batch *batch, ring_buf_size_t size,
+                           uint32_t now);
+
+/*!
+ * \brief Publishes all pending bytes.
+ */
+void ring_buf_batch_flush(struct ring_buf_batch *batch);
+
+/*!
+ * \brief Publishes pending bytes if the oldest has waited too long.
+ * \details Call periodically while the producer idles so that the latency
+ * bound holds even when no further acknowledgements arrive.
+ * \returns True if the batch published.
+ */
+bool ring_buf_batch_poll(struct ring_buf_batch *batch, uint32_t now);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
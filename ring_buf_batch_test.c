@@ -0,0 +1,58 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ring_buf_batch.h"
+
+int ring_buf_batch_test(int argc, char **argv) {
+  RING_BUF_DEFINE(buf, sizeof(float[8U]));
+  struct ring_buf_batch batch;
+  ring_buf_batch_init(&batch, &buf, sizeof(float[8U]), 4U, 10U);
+
+  /*
+   * Three floats stay unpublished. The fourth publishes all four.
+   */
+  for (float number = 1.0F; number <= 3.0F; number += 1.0F) {
+    ring_buf_size_t ack = ring_buf_put(&buf, &number, sizeof(number));
+    assert(ring_buf_batch_put_ack(&batch, ack, 0U) == 0);
+  }
+  assert(ring_buf_is_empty(&buf));
+  assert(ring_buf_free_space(&buf) == sizeof(float[5U]));
+  float number = 4.0F;
+  ring_buf_size_t ack = ring_buf_put(&buf, &number, sizeof(number));
+  assert(ring_buf_batch_put_ack(&batch, ack + 1U, 0U) == -EINVAL);
+  assert(ring_buf_batch_put_ack(&batch, ack, 0U) == 0);
+  assert(ring_buf_used_space(&buf) == sizeof(float[4U]));
+  assert(batch.count == 0U);
+
+  /*
+   * Claimed but unacknowledged space disappears, as with a plain put
+   * acknowledgement.
+   */
+  number = 5.0F;
+  ack = ring_buf_put(&buf, &number, sizeof(number));
+  (void)ring_buf_put(&buf, &number, sizeof(number));
+  assert(ring_buf_batch_put_ack(&batch, ack, 100U) == 0);
+  assert(ring_buf_free_space(&buf) == sizeof(float[3U]));
+
+  /*
+   * The latency bound publishes on polling, or on the next acknowledgement.
+   */
+  assert(!ring_buf_batch_poll(&batch, 109U));
+  assert(ring_buf_used_space(&buf) == sizeof(float[4U]));
+  assert(ring_buf_batch_poll(&batch, 110U));
+  assert(ring_buf_used_space(&buf) == sizeof(float[5U]));
+  assert(!ring_buf_batch_poll(&batch, 200U));
+  number = 6.0F;
+  ack = ring_buf_put(&buf, &number, sizeof(number));
+  assert(ring_buf_batch_put_ack(&batch, ack, UINT32_MAX - 4U) == 0);
+  assert(!ring_buf_batch_poll(&batch, UINT32_MAX));
+  assert(ring_buf_batch_poll(&batch, 5U));
+
+  float sum = 0.0F;
+  while (ring_buf_get_all(&buf, &number, sizeof(number)) == 0)
+    sum += number;
+  assert(sum == 1.0F + 2.0F + 3.0F + 4.0F + 5.0F + 6.0F);
+
+  return EXIT_SUCCESS;
+}
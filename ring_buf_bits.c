@@ -0,0 +1,226 @@
+/*!
+ * \file ring_buf_bits.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_bits.h"
+
+void ring_buf_bits_init(struct ring_buf_bits *bits, struct ring_buf *buf) {
+  bits->buf = buf;
+  bits->put_bits = bits->get_bits = 0U;
+  bits->put_count = bits->get_count = 0U;
+}
+
+int ring_buf_bits_put(struct ring_buf_bits *bits, uint32_t value,
+                      unsigned count) {
+  if (count == 0U || count > 32U)
+    return -EINVAL;
+  unsigned total = bits->put_count + count;
+  unsigned size = total / 8U;
+  if (size > ring_buf_free_space(bits->buf))
+    return -EMSGSIZE;
+  uint64_t mask = (UINT64_C(1) << count) - 1U;
+  bits->put_bits |= (value & mask) << bits->put_count;
+  uint8_t bytes[5U];
+  for (unsigned index = 0U; index < size; index++)
+    bytes[index] = (uint8_t)(bits->put_bits >> (8U * index));
+  (void)ring_buf_put_all(bits->buf, bytes, size);
+  bits->put_bits >>= 8U * size;
+  bits->put_count = total - 8U * size;
+  return 0;
+}
+
+int ring_buf_bits_flush(struct ring_buf_bits *bits) {
+  if (bits->put_count == 0U)
+    return 0;
+  uint8_t byte = (uint8_t)bits->put_bits;
+  if (ring_buf_put_all(bits->buf, &byte, 1U) < 0)
+    return -EMSGSIZE;
+  bits->put_bits = 0U;
+  bits->put_count = 0U;
+  return 0;
+}
+
+int ring_buf_bits_get(struct ring_buf_bits *bits, uint32_t *value,
+                      unsigned count) {
+  if (count == 0U || count > 32U)
+    return -EINVAL;
+  if (count > bits->get_count) {
+    unsigned size = (count - bits->get_count + 7U) / 8U;
+    uint8_t bytes[5U];
+    if (ring_buf_get_all(bits->buf, bytes, size) < 0)
+      return -EAGAIN;
+    for (unsigned index = 0U; index < size; index++)
+      bits->get_bits |= (uint64_t)bytes[index]
+                        << (bits->get_count + 8U * index);
+    bits->get_count += 8U * size;
+  }
+  *value = (uint32_t)(bits->get_bits & ((UINT64_C(1) << count) - 1U));
+  bits->get_bits >>= count;
+  bits->get_count -= count;
+  return 0;
+}
+
+/*!
+ * \brief Chunk geometry for a sample width.
+ * \details A chunk is the largest whole number of byte-filling sample groups
+ * that fits in 64 bits. Widths whose smallest byte-filling group exceeds 64
+ * bits have no chunk.
+ * \returns Number of samples per chunk, or zero.
+ */
+static unsigned ring_buf_bits_chunk(unsigned width, unsigned *size) {
+  unsigned group = 8U;
+  while (group > 1U && (width * (group / 2U)) % 8U == 0U)
+    group /= 2U;
+  if (width * group > 64U)
+    return 0U;
+  unsigned samples = group * (64U / (width * group));
+  *size = samples * width / 8U;
+  return samples;
+}
+
+/*
+ * Constant widths, sample counts and sizes let the compiler unroll both
+ * loops; each of the common widths inlines its own copy.
+ */
+static inline void ring_buf_bits_pack(uint8_t *bytes, const uint16_t *samples,
+                                      ring_buf_size_t chunks, unsigned width,
+                                      unsigned count, unsigned size) {
+  const uint64_t mask = (UINT64_C(1) << width) - 1U;
+  for (; chunks--; samples += count, bytes += size) {
+    uint64_t packed = 0U;
+    for (unsigned index = 0U; index < count; index++)
+      packed |= (samples[index] & mask) << (width * index);
+    for (unsigned index = 0U; index < size; index++)
+      bytes[index] = (uint8_t)(packed >> (8U * index));
+  }
+}
+
+static inline void ring_buf_bits_unpack(uint16_t *samples,
+                                        const uint8_t *bytes,
+                                        ring_buf_size_t chunks, unsigned width,
+                                        unsigned count, unsigned size) {
+  const uint64_t mask = (UINT64_C(1) << width) - 1U;
+  for (; chunks--; samples += count, bytes += size) {
+    uint64_t packed = 0U;
+    for (unsigned index = 0U; index < size; index++)
+      packed |= (uint64_t)bytes[index] << (8U * index);
+    for (unsigned index = 0U; index < count; index++)
+      samples[index] = (uint16_t)((packed >> (width * index)) & mask);
+  }
+}
+
+#define RING_BUF_BITS_KERNEL(_kernel_, _out_, _in_, _chunks_, _width_,         \
+                             _count_, _size_)                                  \
+  switch (_width_) {                                                           \
+  case 1U:                                                                     \
+    _kernel_(_out_, _in_, _chunks_, 1U, 64U, 8U);                              \
+    break;                                                                     \
+  case 4U:                                                                     \
+    _kernel_(_out_, _in_, _chunks_, 4U, 16U, 8U);                              \
+    break;                                                                     \
+  case 10U:                                                                    \
+    _kernel_(_out_, _in_, _chunks_, 10U, 4U, 5U);                              \
+    break;                                                                     \
+  case 12U:                                                                    \
+    _kernel_(_out_, _in_, _chunks_, 12U, 4U, 6U);                              \
+    break;                                                                     \
+  case 14U:                                                                    \
+    _kernel_(_out_, _in_, _chunks_, 14U, 4U, 7U);                              \
+    break;                                                                     \
+  default:                                                                     \
+    _kernel_(_out_, _in_, _chunks_, _width_, _count_, _size_);                 \
+  }
+
+/*
+ * Whole chunks pack straight into contiguous claims. A chunk straddling the
+ * end of the buffer space packs into a temporary and puts across the wrap.
+ * Leftover samples, and all samples while bits remain held back, go one at a
+ * time.
+ */
+ring_buf_size_t ring_buf_bits_put_samples(struct ring_buf_bits *bits,
+                                          const uint16_t *samples,
+                                          ring_buf_size_t count,
+                                          unsigned width) {
+  struct ring_buf *buf = bits->buf;
+  ring_buf_size_t put = 0U;
+  unsigned size, chunk = ring_buf_bits_chunk(width, &size);
+  while (bits->put_count == 0U && chunk && count - put >= chunk) {
+    void *space;
+    ring_buf_size_t chunks = (count - put) / chunk;
+    ring_buf_size_t claim = ring_buf_put_claim(buf, &space, chunks * size);
+    if (claim >= size) {
+      chunks = claim / size;
+      RING_BUF_BITS_KERNEL(ring_buf_bits_pack, space, samples + put, chunks,
+                           width, chunk, size);
+      (void)ring_buf_put_ack(buf, chunks * size);
+    } else {
+      (void)ring_buf_put_ack(buf, 0U);
+      uint8_t bytes[8U];
+      ring_buf_bits_pack(bytes, samples + put, 1U, width, chunk, size);
+      if (ring_buf_put_all(buf, bytes, size) < 0)
+        break;
+      chunks = 1U;
+    }
+    put += chunks * chunk;
+  }
+  for (; put < count; put++)
+    if (ring_buf_bits_put(bits, samples[put], width) < 0)
+      break;
+  return put;
+}
+
+ring_buf_size_t ring_buf_bits_get_samples(struct ring_buf_bits *bits,
+                                          uint16_t *samples,
+                                          ring_buf_size_t count,
+                                          unsigned width) {
+  struct ring_buf *buf = bits->buf;
+  ring_buf_size_t got = 0U;
+  unsigned size, chunk = ring_buf_bits_chunk(width, &size);
+  while (bits->get_count == 0U && chunk && count - got >= chunk) {
+    void *space;
+    ring_buf_size_t chunks = (count - got) / chunk;
+    ring_buf_size_t claim = ring_buf_get_claim(buf, &space, chunks * size);
+    if (claim >= size) {
+      chunks = claim / size;
+      RING_BUF_BITS_KERNEL(ring_buf_bits_unpack, samples + got, space, chunks,
+                           width, chunk, size);
+      (void)ring_buf_get_ack(buf, chunks * size);
+    } else {
+      (void)ring_buf_get_ack(buf, 0U);
+      uint8_t bytes[8U];
+      if (ring_buf_get_all(buf, bytes, size) < 0)
+        break;
+      ring_buf_bits_unpack(samples + got, bytes, 1U, width, chunk, size);
+      chunks = 1U;
+    }
+    got += chunks * chunk;
+  }
+  for (uint32_t value; got < count; got++) {
+    if (ring_buf_bits_get(bits, &value, width) < 0)
+      break;
+    samples[got] = (uint16_t)value;
+  }
+  return got;
+}
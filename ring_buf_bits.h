@@ -0,0 +1,125 @@
+/*!
+ * \file ring_buf_bits.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf.h"
+
+/*!
+ * \defgroup ring_buf_bits Bit Ring Buffer
+ * \ingroup ring_buf_bits
+ * \brief Bit-granular putting and getting over a byte ring buffer.
+ * \details Packs values of 1 to 32 bits end to end, least-significant bit
+ * first, with no padding between them. Each side keeps a small accumulator of
+ * bits not yet whole bytes: the putter holds back up to seven bits until more
+ * arrive or until it flushes; the getter holds the bits of its last byte
+ * that it has not yet got.
+ *
+ * Bulk sample kernels pack and unpack arrays of samples straight into and
+ * out of the ring buffer's claims, handling the wrap. They process chunks of
+ * samples that fill whole bytes, up to eight bytes at once. Each of the
+ * common widths, 1, 4, 10, 12 and 14 bits, has its own unrolled kernel that
+ * compilers can vectorise. Other widths run the same code unspecialised, or
+ * bit by bit when no chunk fits in 64 bits.
+ * \{
+ */
+
+struct ring_buf_bits {
+  struct ring_buf *buf;
+  uint64_t put_bits, get_bits;
+  unsigned put_count, get_count;
+};
+
+void ring_buf_bits_init(struct ring_buf_bits *bits, struct ring_buf *buf);
+
+/*!
+ * \brief Number of bits available to get.
+ */
+static inline ring_buf_size_t
+ring_buf_bits_used(const struct ring_buf_bits *bits) {
+  return 8U * ring_buf_used_space(bits->buf) + bits->get_count;
+}
+
+/*!
+ * \brief Puts the low bits of a value.
+ * \details Puts whole bytes and acknowledges them at once, holding back any
+ * remaining bits.
+ * \param count Number of bits, 1 to 32.
+ * \retval 0 on success.
+ * \retval -EINVAL if \c count is out of range.
+ * \retval -EMSGSIZE if the buffer has insufficient space.
+ */
+int ring_buf_bits_put(struct ring_buf_bits *bits, uint32_t value,
+                      unsigned count);
+
+/*!
+ * \brief Puts held-back bits, padding with zeros to a whole byte.
+ * \retval 0 on success.
+ * \retval -EMSGSIZE if the buffer has no space for the final byte.
+ */
+int ring_buf_bits_flush(struct ring_buf_bits *bits);
+
+/*!
+ * \brief Gets a value of so many bits.
+ * \param count Number of bits, 1 to 32.
+ * \retval 0 on success.
+ * \retval -EINVAL if \c count is out of range.
+ * \retval -EAGAIN if the buffer holds insufficient bits.
+ */
+int ring_buf_bits_get(struct ring_buf_bits *bits, uint32_t *value,
+                      unsigned count);
+
+/*!
+ * \brief Puts samples of a given width.
+ * \param width Bits per sample, 1 to 16.
+ * \returns Number of samples put, fewer than \c count if the buffer fills.
+ */
+ring_buf_size_t ring_buf_bits_put_samples(struct ring_buf_bits *bits,
+                                          const uint16_t *samples,
+                                          ring_buf_size_t count,
+                                          unsigned width);
+
+/*!
+ * \brief Gets samples of a given width.
+ * \param width Bits per sample, 1 to 16.
+ * \returns Number of samples got, fewer than \c count if the buffer runs out.
+ */
+ring_buf_size_t ring_buf_bits_get_samples(struct ring_buf_bits *bits,
+                                          uint16_t *samples,
+                                          ring_buf_size_t count,
+                                          unsigned width);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,63 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "ring_buf_bits.h"
+
+int ring_buf_bits_test(int argc, char **argv) {
+  RING_BUF_DEFINE(buf, 61U);
+  struct ring_buf_bits bits;
+  ring_buf_bits_init(&bits, &buf);
+
+  /*
+   * A 12-bit sample and a 1-bit flag take 13 bits, not 24.
+   */
+  uint32_t value;
+  assert(ring_buf_bits_put(&bits, 0xABCU, 12U) == 0);
+  assert(ring_buf_bits_put(&bits, 1U, 1U) == 0);
+  assert(ring_buf_bits_put(&bits, 0U, 33U) == -EINVAL);
+  assert(ring_buf_used_space(&buf) == 1U);
+  assert(ring_buf_bits_flush(&bits) == 0);
+  assert(ring_buf_used_space(&buf) == 2U && ring_buf_bits_used(&bits) == 16U);
+  assert(ring_buf_bits_get(&bits, &value, 12U) == 0 && value == 0xABCU);
+  assert(ring_buf_bits_get(&bits, &value, 1U) == 0 && value == 1U);
+  assert(ring_buf_bits_get(&bits, &value, 4U) == -EAGAIN);
+  assert(ring_buf_bits_get(&bits, &value, 3U) == 0 && value == 0U);
+
+  /*
+   * Stream samples of each width through the small ring in uneven batches.
+   * Chunks straddle the end of the buffer space at varying offsets.
+   */
+  static const unsigned widths[] = {1U, 4U, 10U, 12U, 14U, 16U, 9U, 3U};
+  for (size_t w = 0U; w < sizeof(widths) / sizeof(widths[0]); w++) {
+    unsigned width = widths[w];
+    uint16_t mask = (uint16_t)((1UL << width) - 1U);
+    uint16_t samples[100U], got[100U];
+    uint16_t next = 0U, expect = 0U;
+    for (int round = 0; round < 50; round++) {
+      ring_buf_size_t count = 1U + (ring_buf_size_t)(round * 7) % 100U;
+      for (ring_buf_size_t i = 0U; i < count; i++)
+        samples[i] = (uint16_t)((next + i) * 40503U) & mask;
+      ring_buf_size_t put =
+          ring_buf_bits_put_samples(&bits, samples, count, width);
+      next = (uint16_t)(next + put);
+      ring_buf_size_t get = ring_buf_bits_get_samples(&bits, got, 100U, width);
+      for (ring_buf_size_t i = 0U; i < get; i++, expect++)
+        assert(got[i] == ((uint16_t)(expect * 40503U) & mask));
+    }
+    assert(expect > 0U);
+    /*
+     * Flushing pads to a whole byte; padding bits may amount to a sample.
+     */
+    assert(ring_buf_bits_flush(&bits) == 0);
+    ring_buf_size_t get = ring_buf_bits_get_samples(
+        &bits, got, (uint16_t)(next - expect), width);
+    for (ring_buf_size_t i = 0U; i < get; i++, expect++)
+      assert(got[i] == ((uint16_t)(expect * 40503U) & mask));
+    assert(expect == next);
+    (void)ring_buf_get_all(&buf, NULL, ring_buf_used_space(&buf));
+    ring_buf_bits_init(&bits, &buf);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,236 @@
+/*!
+ * \file ring_buf_co.hpp
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <span>
+
+#include "ring_buf.h"
+
+/*!
+ * \defgroup ring_buf_co Ring Buffer Coroutines
+ * \ingroup ring_buf_co
+ * \brief C++20 awaitable put and get over a ring buffer.
+ * \details Wraps a plain C ring buffer. Awaiting a get suspends the coroutine
+ * until the ring buffer holds all the requested bytes; awaiting a put suspends
+ * until the ring buffer has room for all the given bytes. Both transfer all or
+ * none, and both acknowledge their own claims.
+ *
+ * Suspended coroutines wait in first-in, first-out order. Each waiter lives
+ * inside its awaiter and hence inside the coroutine frame: awaiting allocates
+ * nothing. A put wakes the waiting getters and a get wakes the waiting
+ * putters. The ring completes the waiter's transfer on its behalf and then
+ * posts the waiter's coroutine handle to the executor for resumption.
+ *
+ * Access is \e not thread safe. The ring, its executor and all its coroutines
+ * belong to one thread, or to one strand of execution.
+ * \{
+ */
+
+namespace ring_buf_co {
+
+/*!
+ * \brief Resumes a coroutine immediately.
+ * \details An executor is any class with a \c post member function accepting
+ * a coroutine handle. The inline executor resumes the handle there and then,
+ * within the put or get that woke it.
+ */
+struct inline_executor {
+  void post(std::coroutine_handle<> handle) { handle.resume(); }
+};
+
+/*!
+ * \brief Awaitable ring buffer.
+ * \tparam Executor Class of executor that resumes woken coroutines.
+ */
+template <typename Executor = inline_executor> class ring {
+  /*!
+   * \brief Suspended transfer.
+   * \details Intrusive singly-linked queue node. The data and size describe
+   * the outstanding transfer.
+   */
+  struct waiter {
+    waiter *next = nullptr;
+    std::coroutine_handle<> handle;
+    std::byte *data;
+    ring_buf_size_t size;
+  };
+
+  struct queue {
+    waiter *first = nullptr, *last = nullptr;
+    void push(waiter *node) {
+      node->next = nullptr;
+      (last ? last->next : first) = node;
+      last = node;
+    }
+    waiter *pop() {
+      waiter *node = first;
+      if ((first = node->next) == nullptr)
+        last = nullptr;
+      return node;
+    }
+    bool empty() const { return first == nullptr; }
+  };
+
+public:
+  ring(struct ring_buf &buf, Executor &executor)
+      : buf_(buf), executor_(executor) {}
+
+  ring(const ring &) = delete;
+  ring &operator=(const ring &) = delete;
+
+  /*!
+   * \brief Awaits getting bytes from the ring buffer.
+   * \details Resumes with the number of bytes got: either all of them, or
+   * zero immediately if the request exceeds the ring buffer's entire size
+   * since that request could never succeed.
+   */
+  class get_awaiter {
+  public:
+    get_awaiter(ring &ring, std::span<std::byte> data) : ring_(ring) {
+      waiter_.data = data.data();
+      waiter_.size = data.size();
+    }
+    bool await_ready() {
+      if (waiter_.size > ring_.buf_.size) {
+        waiter_.size = 0U;
+        return true;
+      }
+      if (!ring_.getters_.empty() ||
+          ring_buf_get_all(&ring_.buf_, waiter_.data, waiter_.size) < 0)
+        return false;
+      ring_.notify();
+      return true;
+    }
+    void await_suspend(std::coroutine_handle<> handle) {
+      waiter_.handle = handle;
+      ring_.getters_.push(&waiter_);
+    }
+    ring_buf_size_t await_resume() const { return waiter_.size; }
+
+  private:
+    ring &ring_;
+    waiter waiter_;
+  };
+
+  /*!
+   * \brief Awaits putting bytes into the ring buffer.
+   * \details Resumes with the number of bytes put, all or zero. Zero only
+   * arises when the request exceeds the ring buffer's entire size.
+   */
+  class put_awaiter {
+  public:
+    put_awaiter(ring &ring, std::span<const std::byte> data) : ring_(ring) {
+      waiter_.data = const_cast<std::byte *>(data.data());
+      waiter_.size = data.size();
+    }
+    bool await_ready() {
+      if (waiter_.size > ring_.buf_.size) {
+        waiter_.size = 0U;
+        return true;
+      }
+      if (!ring_.putters_.empty() ||
+          ring_buf_put_all(&ring_.buf_, waiter_.data, waiter_.size) < 0)
+        return false;
+      ring_.notify();
+      return true;
+    }
+    void await_suspend(std::coroutine_handle<> handle) {
+      waiter_.handle = handle;
+      ring_.putters_.push(&waiter_);
+    }
+    ring_buf_size_t await_resume() const { return waiter_.size; }
+
+  private:
+    ring &ring_;
+    waiter waiter_;
+  };
+
+  get_awaiter get(std::span<std::byte> data) { return {*this, data}; }
+
+  put_awaiter put(std::span<const std::byte> data) { return {*this, data}; }
+
+  /*!
+   * \brief Completes waiting transfers.
+   * \details Services the waiting getters and putters in order until neither
+   * can make progress, then posts the completed waiters' coroutine handles.
+   * Awaiting calls this automatically. Call it explicitly after putting or
+   * getting through the plain C interface so that waiting coroutines see the
+   * change.
+   *
+   * Notifying does not nest. A coroutine resumed by the inline executor runs
+   * within the outer notify; its own notifies, whether by awaiting or
+   * explicitly, only flag the outer notify to go round again. Hand-overs
+   * between coroutines therefore loop rather than recurse ever deeper.
+   */
+  void notify() {
+    if (notifying_) {
+      renotify_ = true;
+      return;
+    }
+    notifying_ = true;
+    do {
+      renotify_ = false;
+      queue ready;
+      bool progress;
+      do {
+        progress = false;
+        while (!getters_.empty() &&
+               ring_buf_get_all(&buf_, getters_.first->data,
+                                getters_.first->size) == 0) {
+          ready.push(getters_.pop());
+          progress = true;
+        }
+        while (!putters_.empty() &&
+               ring_buf_put_all(&buf_, putters_.first->data,
+                                putters_.first->size) == 0) {
+          ready.push(putters_.pop());
+          progress = true;
+        }
+      } while (progress);
+      /*
+       * Pop before posting. Resuming may destroy the waiter's frame.
+       */
+      while (!ready.empty())
+        executor_.post(ready.pop()->handle);
+    } while (renotify_);
+    notifying_ = false;
+  }
+
+private:
+  struct ring_buf &buf_;
+  Executor &executor_;
+  queue getters_, putters_;
+  bool notifying_ = false, renotify_ = false;
+};
+
+} // namespace ring_buf_co
+
+/*!
+ * \}
+ */
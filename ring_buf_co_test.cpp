@@ -0,0 +1,151 @@
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+
+#include "ring_buf_co.hpp"
+
+namespace {
+
+struct queue_executor {
+  std::deque<std::coroutine_handle<>> handles;
+  void post(std::coroutine_handle<> handle) { handles.push_back(handle); }
+  void run() {
+    while (!handles.empty()) {
+      std::coroutine_handle<> handle = handles.front();
+      handles.pop_front();
+      handle.resume();
+    }
+  }
+};
+
+struct task {
+  struct promise_type {
+    task get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::abort(); }
+  };
+};
+
+task get_floats(ring_buf_co::ring<queue_executor> &ring, float *sum, int n) {
+  for (int i = 0; i < n; i++) {
+    float number;
+    ring_buf_size_t size = co_await ring.get(
+        std::as_writable_bytes(std::span<float>(&number, 1U)));
+    assert(size == sizeof(number));
+    *sum += number;
+  }
+}
+
+task put_floats(ring_buf_co::ring<queue_executor> &ring, int n) {
+  for (int i = 1; i <= n; i++) {
+    float number = static_cast<float>(i);
+    ring_buf_size_t size = co_await ring.put(
+        std::as_bytes(std::span<const float>(&number, 1U)));
+    assert(size == sizeof(number));
+  }
+}
+
+task put_oversize(ring_buf_co::ring<> &ring, std::span<std::byte> bytes) {
+  ring_buf_size_t size = co_await ring.put(bytes);
+  assert(size == 0U);
+}
+
+/*
+ * Resumes inline but records how deeply posts nest.
+ */
+struct depth_executor {
+  int depth = 0, deepest = 0;
+  void post(std::coroutine_handle<> handle) {
+    if (++depth > deepest)
+      deepest = depth;
+    handle.resume();
+    depth--;
+  }
+};
+
+/*
+ * Gets a byte and puts it straight back through the plain C interface,
+ * notifying the ring, until the hops run out.
+ */
+task echo(ring_buf_co::ring<depth_executor> &ring, struct ring_buf &buf,
+          int *hops, int *finished) {
+  for (;;) {
+    std::byte byte;
+    co_await ring.get(std::span<std::byte>(&byte, 1U));
+    bool last = *hops == 0;
+    if (!last)
+      --*hops;
+    assert(ring_buf_put_all(&buf, &byte, 1U) == 0);
+    ring.notify();
+    if (last)
+      break;
+  }
+  ++*finished;
+}
+
+} // namespace
+
+extern "C" int ring_buf_co_test(int argc, char **argv) {
+  {
+    RING_BUF_DEFINE(buf, sizeof(float[2U]));
+    queue_executor executor;
+    ring_buf_co::ring<queue_executor> ring(buf, executor);
+    float sum = 0.0F;
+    get_floats(ring, &sum, 10);
+    assert(sum == 0.0F);
+    put_floats(ring, 10);
+    executor.run();
+    assert(sum == 55.0F);
+    assert(ring_buf_is_empty(&buf));
+  }
+
+  {
+    RING_BUF_DEFINE(buf, sizeof(float[2U]));
+    queue_executor executor;
+    ring_buf_co::ring<queue_executor> ring(buf, executor);
+    put_floats(ring, 3);
+    assert(ring_buf_is_full(&buf));
+    assert(executor.handles.empty());
+    float number;
+    assert(ring_buf_get_all(&buf, &number, sizeof(number)) == 0);
+    assert(number == 1.0F);
+    ring.notify();
+    assert(executor.handles.size() == 1U);
+    executor.run();
+    float sum = 0.0F;
+    get_floats(ring, &sum, 2);
+    assert(sum == 2.0F + 3.0F);
+  }
+
+  {
+    RING_BUF_DEFINE(buf, 1U);
+    ring_buf_co::inline_executor executor;
+    ring_buf_co::ring<> ring(buf, executor);
+    std::byte bytes[2U] = {};
+    put_oversize(ring, bytes);
+  }
+
+  /*
+   * Echoes pass one byte around eight coroutines. Each echo notifies from
+   * within the notify that resumed it; the nested notify defers to the outer
+   * one rather than resuming the next echo one level deeper.
+   */
+  {
+    RING_BUF_DEFINE(buf, 1U);
+    depth_executor executor;
+    ring_buf_co::ring<depth_executor> ring(buf, executor);
+    int hops = 1000, finished = 0;
+    for (int i = 0; i < 8; i++)
+      echo(ring, buf, &hops, &finished);
+    std::byte byte{};
+    assert(ring_buf_put_all(&buf, &byte, 1U) == 0);
+    ring.notify();
+    assert(hops == 0 && finished == 8);
+    assert(executor.deepest == 1);
+  }
+
+  return EXIT_SUCCESS;
+}
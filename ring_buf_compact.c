@@ -0,0 +1,115 @@
+/*!
+ * \file ring_buf_compact.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_compact.h"
+
+#include <string.h>
+
+int ring_buf_compact_init(struct ring_buf_compact *ring, void *space,
+                          ring_buf_size_t size) {
+  if (size == 0U || (size & (size - 1U)) || size > RING_BUF_COMPACT_SIZE_MAX)
+    return -EINVAL;
+  ring->space = space;
+  ring->mask = (uint32_t)(size - 1U);
+  ring->put = ring->get = 0U;
+  return 0;
+}
+
+/*!
+ * \brief Contiguous bytes at an index, clamped to an available number.
+ */
+static inline ring_buf_size_t
+ring_buf_compact_claim(const struct ring_buf_compact *ring, uint32_t index,
+                       void **space, ring_buf_size_t size,
+                       ring_buf_size_t available) {
+  uint32_t offset = index & ring->mask;
+  ring_buf_size_t contiguous = ring->mask + 1U - offset;
+  if (size > contiguous)
+    size = contiguous;
+  if (size > available)
+    size = available;
+  if (space)
+    *space = (uint8_t *)ring->space + offset;
+  return size;
+}
+
+ring_buf_size_t ring_buf_compact_put_claim(struct ring_buf_compact *ring,
+                                           void **space,
+                                           ring_buf_size_t size) {
+  return ring_buf_compact_claim(ring, ring->put, space, size,
+                                ring_buf_compact_free_space(ring));
+}
+
+int ring_buf_compact_put_ack(struct ring_buf_compact *ring,
+                             ring_buf_size_t size) {
+  if (size > ring_buf_compact_free_space(ring))
+    return -EINVAL;
+  ring->put += (uint32_t)size;
+  return 0;
+}
+
+ring_buf_size_t ring_buf_compact_get_claim(struct ring_buf_compact *ring,
+                                           void **space,
+                                           ring_buf_size_t size) {
+  return ring_buf_compact_claim(ring, ring->get, space, size,
+                                ring_buf_compact_used_space(ring));
+}
+
+int ring_buf_compact_get_ack(struct ring_buf_compact *ring,
+                             ring_buf_size_t size) {
+  if (size > ring_buf_compact_used_space(ring))
+    return -EINVAL;
+  ring->get += (uint32_t)size;
+  return 0;
+}
+
+/*
+ * Copies wrap at most once: the first copy runs to the end of the buffer
+ * space and the second from its start.
+ */
+int ring_buf_compact_put_all(struct ring_buf_compact *ring, const void *data,
+                             ring_buf_size_t size) {
+  if (size > ring_buf_compact_free_space(ring))
+    return -EMSGSIZE;
+  void *space;
+  ring_buf_size_t first = ring_buf_compact_put_claim(ring, &space, size);
+  (void)memcpy(space, data, first);
+  (void)memcpy(ring->space, (const uint8_t *)data + first, size - first);
+  ring->put += (uint32_t)size;
+  return 0;
+}
+
+int ring_buf_compact_get_all(struct ring_buf_compact *ring, void *data,
+                             ring_buf_size_t size) {
+  if (size > ring_buf_compact_used_space(ring))
+    return -EAGAIN;
+  void *space;
+  ring_buf_size_t first = ring_buf_compact_get_claim(ring, &space, size);
+  (void)memcpy(data, space, first);
+  (void)memcpy((uint8_t *)data + first, ring->space, size - first);
+  ring->get += (uint32_t)size;
+  return 0;
+}
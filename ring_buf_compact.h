@@ -0,0 +1,143 @@
+/*!
+ * \file ring_buf_compact.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "ring_buf.h"
+
+/*!
+ * \defgroup ring_buf_compact Compact Ring Buffer
+ * \ingroup ring_buf_compact
+ * \brief Small-header ring buffer for very many rings.
+ * \details A compact ring buffer trades generality for header size. Its
+ * indices are free-running 32-bit byte counts with no base fields; the space
+ * offset is the index masked by the power-of-two size less one. The header
+ * holds a space pointer, the mask and one index per zone: 24 bytes on 64-bit
+ * targets, 16 bytes on 32-bit targets. A cache line holds headers for two or
+ * four rings, against one for the full ring buffer.
+ *
+ * Sizes must be powers of two no greater than 2<sup>31</sup> bytes so that
+ * unsigned index differences remain unambiguous across index wrap-around.
+ *
+ * Claims do not advance the zone. Each side has at most one claim
+ * outstanding: claiming answers contiguous space at the zone's index and
+ * acknowledging moves the index on. Claiming twice without acknowledging
+ * answers the same space twice. Passive iteration and multiple concurrent
+ * claims need the full ring buffer.
+ * \{
+ */
+
+#define RING_BUF_COMPACT_SIZE_MAX (UINT32_C(1) << 31)
+
+/*!
+ * \brief Compact ring buffer instance.
+ */
+struct ring_buf_compact {
+  void *space;
+  uint32_t mask, put, get;
+};
+
+/*!
+ * \brief Initialises an empty compact ring buffer.
+ * \param space Buffer space of \c size bytes.
+ * \param size Power of two up to \c RING_BUF_COMPACT_SIZE_MAX.
+ * \retval 0 on success.
+ * \retval -EINVAL if \c size is zero, not a power of two or too large.
+ */
+int ring_buf_compact_init(struct ring_buf_compact *ring, void *space,
+                          ring_buf_size_t size);
+
+static inline ring_buf_size_t
+ring_buf_compact_used_space(const struct ring_buf_compact *ring) {
+  return (uint32_t)(ring->put - ring->get);
+}
+
+static inline ring_buf_size_t
+ring_buf_compact_free_space(const struct ring_buf_compact *ring) {
+  return ring->mask + 1U - ring_buf_compact_used_space(ring);
+}
+
+/*!
+ * \brief Claims contiguous free space without advancing.
+ * \returns Number of contiguous free bytes up to \c size.
+ */
+ring_buf_size_t ring_buf_compact_put_claim(struct ring_buf_compact *ring,
+                                           void **space,
+                                           ring_buf_size_t size);
+
+/*!
+ * \brief Acknowledges bytes put.
+ * \retval 0 on success.
+ * \retval -EINVAL if \c size exceeds the free space.
+ */
+int ring_buf_compact_put_ack(struct ring_buf_compact *ring,
+                             ring_buf_size_t size);
+
+/*!
+ * \brief Claims contiguous used space without advancing.
+ * \returns Number of contiguous used bytes up to \c size.
+ */
+ring_buf_size_t ring_buf_compact_get_claim(struct ring_buf_compact *ring,
+                                           void **space,
+                                           ring_buf_size_t size);
+
+/*!
+ * \brief Acknowledges bytes got.
+ * \retval 0 on success.
+ * \retval -EINVAL if \c size exceeds the used space.
+ */
+int ring_buf_compact_get_ack(struct ring_buf_compact *ring,
+                             ring_buf_size_t size);
+
+/*!
+ * \brief Puts all or nothing.
+ * \retval 0 on success.
+ * \retval -EMSGSIZE if insufficient space.
+ */
+int ring_buf_compact_put_all(struct ring_buf_compact *ring, const void *data,
+                             ring_buf_size_t size);
+
+/*!
+ * \brief Gets all or nothing.
+ * \retval 0 on success.
+ * \retval -EAGAIN if insufficient data.
+ */
+int ring_buf_compact_get_all(struct ring_buf_compact *ring, void *data,
+                             ring_buf_size_t size);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,49 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_buf_compact.h"
+
+int ring_buf_compact_test(int argc, char **argv) {
+  static uint8_t space[16U];
+  struct ring_buf_compact ring;
+  assert(ring_buf_compact_init(&ring, space, 12U) == -EINVAL);
+  assert(ring_buf_compact_init(&ring, space, 0U) == -EINVAL);
+  assert(ring_buf_compact_init(&ring, space, sizeof(space)) == 0);
+  assert(sizeof(ring) <= sizeof(void *) + sizeof(uint32_t[4U]));
+
+  /*
+   * Start the indices just short of 32-bit wrap-around. Transfers must cross
+   * it transparently.
+   */
+  ring.put = ring.get = UINT32_MAX - 20U;
+  uint8_t data[11U], got[11U];
+  for (uint8_t round = 0U; round < 10U; round++) {
+    (void)memset(data, round, sizeof(data));
+    assert(ring_buf_compact_put_all(&ring, data, sizeof(data)) == 0);
+    assert(ring_buf_compact_put_all(&ring, data, sizeof(data)) == -EMSGSIZE);
+    assert(ring_buf_compact_used_space(&ring) == sizeof(data));
+    assert(ring_buf_compact_free_space(&ring) == 5U);
+    assert(ring_buf_compact_get_all(&ring, got, sizeof(got)) == 0);
+    assert(memcmp(data, got, sizeof(got)) == 0);
+    assert(ring_buf_compact_get_all(&ring, got, 1U) == -EAGAIN);
+  }
+
+  /*
+   * Claims do not advance: claiming again answers the same space.
+   */
+  void *space1, *space2;
+  assert(ring_buf_compact_put_claim(&ring, &space1, 4U) == 4U);
+  assert(ring_buf_compact_put_claim(&ring, &space2, 4U) == 4U);
+  assert(space1 == space2);
+  assert(ring_buf_compact_put_ack(&ring, 4U) == 0);
+  assert(ring_buf_compact_put_ack(&ring, 13U) == -EINVAL);
+  assert(ring_buf_compact_get_claim(&ring, &space2, 16U) == 4U);
+  assert(space1 == space2);
+  assert(ring_buf_compact_get_ack(&ring, 5U) == -EINVAL);
+  assert(ring_buf_compact_get_ack(&ring, 4U) == 0);
+  assert(ring_buf_compact_used_space(&ring) == 0U);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,214 @@
+/*!
+ * \file ring_buf_convert.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_convert.h"
+
+#include <string.h>
+
+/*
+ * Byte-wise loads and stores compile to plain or byte-swapping loads and
+ * stores, unaligned where necessary, on any host byte order.
+ */
+static inline uint32_t ring_buf_convert_load(const uint8_t *space,
+                                             enum ring_buf_format fmt) {
+  switch (fmt) {
+  case RING_BUF_FMT_S16: {
+    uint16_t bits;
+    (void)memcpy(&bits, space, sizeof(bits));
+    return bits;
+  }
+  case RING_BUF_FMT_S16LE:
+    return (uint32_t)space[0] | (uint32_t)space[1] << 8;
+  case RING_BUF_FMT_S16BE:
+    return (uint32_t)space[0] << 8 | (uint32_t)space[1];
+  case RING_BUF_FMT_S32:
+  case RING_BUF_FMT_F32: {
+    uint32_t bits;
+    (void)memcpy(&bits, space, sizeof(bits));
+    return bits;
+  }
+  case RING_BUF_FMT_S32LE:
+  case RING_BUF_FMT_F32LE:
+    return (uint32_t)space[0] | (uint32_t)space[1] << 8 |
+           (uint32_t)space[2] << 16 | (uint32_t)space[3] << 24;
+  default:
+    return (uint32_t)space[0] << 24 | (uint32_t)space[1] << 16 |
+           (uint32_t)space[2] << 8 | (uint32_t)space[3];
+  }
+}
+
+static inline void ring_buf_convert_store(uint8_t *space,
+                                          enum ring_buf_format fmt,
+                                          uint32_t bits) {
+  switch (fmt) {
+  case RING_BUF_FMT_S16: {
+    uint16_t half = (uint16_t)bits;
+    (void)memcpy(space, &half, sizeof(half));
+    break;
+  }
+  case RING_BUF_FMT_S16LE:
+    space[0] = (uint8_t)bits;
+    space[1] = (uint8_t)(bits >> 8);
+    break;
+  case RING_BUF_FMT_S16BE:
+    space[0] = (uint8_t)(bits >> 8);
+    space[1] = (uint8_t)bits;
+    break;
+  case RING_BUF_FMT_S32:
+  case RING_BUF_FMT_F32:
+    (void)memcpy(space, &bits, sizeof(bits));
+    break;
+  case RING_BUF_FMT_S32LE:
+  case RING_BUF_FMT_F32LE:
+    space[0] = (uint8_t)bits;
+    space[1] = (uint8_t)(bits >> 8);
+    space[2] = (uint8_t)(bits >> 16);
+    space[3] = (uint8_t)(bits >> 24);
+    break;
+  default:
+    space[0] = (uint8_t)(bits >> 24);
+    space[1] = (uint8_t)(bits >> 16);
+    space[2] = (uint8_t)(bits >> 8);
+    space[3] = (uint8_t)bits;
+  }
+}
+
+static inline bool ring_buf_format_is_float(enum ring_buf_format fmt) {
+  return fmt >= RING_BUF_FMT_F32;
+}
+
+/*
+ * Converts a 32-bit fixed-point fraction to float. Two's-complement bits
+ * convert without relying on implementation-defined narrowing.
+ */
+static inline float ring_buf_convert_to_float(uint32_t bits) {
+  int32_t value = bits < UINT32_C(0x80000000) ? (int32_t)bits
+                                              : -(int32_t)~bits - 1;
+  return (float)value * (1.0F / 2147483648.0F);
+}
+
+/*
+ * Rounds to nearest, saturating at the bounds, and answers two's-complement
+ * bits of the given width. Out-of-range and not-a-number floats saturate.
+ */
+static inline uint32_t ring_buf_convert_from_float(float value,
+                                                   ring_buf_size_t size) {
+  const double scale = size == 2U ? 32768.0 : 2147483648.0;
+  double scaled = (double)value * scale;
+  if (!(scaled < scale - 0.5))
+    return size == 2U ? UINT32_C(0x7fff) : UINT32_C(0x7fffffff);
+  if (!(scaled >= -scale))
+    return size == 2U ? UINT32_C(0x8000) : UINT32_C(0x80000000);
+  int32_t rounded = (int32_t)(scaled < 0.0 ? scaled - 0.5 : scaled + 0.5);
+  return (uint32_t)rounded & (size == 2U ? UINT32_C(0xffff) : UINT32_MAX);
+}
+
+static inline void ring_buf_convert(uint8_t *data, const uint8_t *space,
+                                    ring_buf_size_t count,
+                                    enum ring_buf_format from,
+                                    enum ring_buf_format to) {
+  const ring_buf_size_t from_size = ring_buf_format_size(from),
+                        to_size = ring_buf_format_size(to);
+  for (ring_buf_size_t index = 0U; index < count; index++) {
+    uint32_t bits = ring_buf_convert_load(space + index * from_size, from);
+    if (ring_buf_format_is_float(from)) {
+      if (!ring_buf_format_is_float(to)) {
+        float value;
+        (void)memcpy(&value, &bits, sizeof(value));
+        bits = ring_buf_convert_from_float(value, to_size);
+      }
+    } else {
+      bits <<= 32U - 8U * from_size;
+      if (ring_buf_format_is_float(to)) {
+        float value = ring_buf_convert_to_float(bits);
+        (void)memcpy(&bits, &value, sizeof(bits));
+      } else
+        bits >>= 32U - 8U * to_size;
+    }
+    ring_buf_convert_store(data + index * to_size, to, bits);
+  }
+}
+
+#define RING_BUF_CONVERT_CASE(_from_, _to_)                                    \
+  case RING_BUF_FMT_##_from_ * 16 + RING_BUF_FMT_##_to_:                       \
+    ring_buf_convert(data, space, count, RING_BUF_FMT_##_from_,                \
+                     RING_BUF_FMT_##_to_);                                     \
+    break
+
+/*
+ * Constant formats reduce the loads, stores and conversions to straight-line
+ * code for the most common pairs.
+ */
+static void ring_buf_convert_kernel(uint8_t *data, const uint8_t *space,
+                                    ring_buf_size_t count,
+                                    enum ring_buf_format from,
+                                    enum ring_buf_format to) {
+  switch (from * 16 + to) {
+    RING_BUF_CONVERT_CASE(S16, F32);
+    RING_BUF_CONVERT_CASE(S16LE, F32);
+    RING_BUF_CONVERT_CASE(S16BE, F32);
+    RING_BUF_CONVERT_CASE(S32LE, F32);
+    RING_BUF_CONVERT_CASE(S32BE, F32);
+    RING_BUF_CONVERT_CASE(F32BE, F32);
+    RING_BUF_CONVERT_CASE(S16BE, S16);
+    RING_BUF_CONVERT_CASE(F32, S16);
+  default:
+    ring_buf_convert(data, space, count, from, to);
+  }
+}
+
+int ring_buf_get_convert(struct ring_buf *buf, void *data,
+                         ring_buf_size_t count, enum ring_buf_format from,
+                         enum ring_buf_format to) {
+  if ((unsigned)from > RING_BUF_FMT_F32BE || (unsigned)to > RING_BUF_FMT_F32BE)
+    return -EINVAL;
+  const ring_buf_size_t from_size = ring_buf_format_size(from),
+                        to_size = ring_buf_format_size(to);
+  ring_buf_size_t used = ring_buf_used_space(buf) / from_size;
+  if (count > used)
+    count = used;
+  ring_buf_size_t got = 0U;
+  while (got < count) {
+    void *space;
+    ring_buf_size_t claim =
+        ring_buf_get_claim(buf, &space, (count - got) * from_size) /
+        from_size;
+    if (claim) {
+      ring_buf_convert_kernel((uint8_t *)data + got * to_size, space, claim,
+                              from, to);
+      (void)ring_buf_get_ack(buf, claim * from_size);
+      got += claim;
+    } else {
+      (void)ring_buf_get_ack(buf, 0U);
+      uint8_t temporary[4U];
+      (void)ring_buf_get_all(buf, temporary, from_size);
+      ring_buf_convert((uint8_t *)data + got * to_size, temporary, 1U, from,
+                       to);
+      got++;
+    }
+  }
+  return (int)got;
+}
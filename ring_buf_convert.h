@@ -0,0 +1,96 @@
+/*!
+ * \file ring_buf_convert.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf.h"
+
+/*!
+ * \defgroup ring_buf_convert Ring Buffer Sample Conversion
+ * \ingroup ring_buf_convert
+ * \brief Converts sample formats while getting.
+ * \details Getting converts each sample as it copies it out of the claimed
+ * space, one read and one write per sample rather than a copy followed by a
+ * second conversion pass over the copy.
+ *
+ * Formats combine an encoding, signed 16-bit or 32-bit integer or
+ * single-precision float, with a byte order: little endian, big endian or
+ * native. Integers are fixed-point fractions; floats span -1 to +1. Converting
+ * floats to integers rounds to nearest and saturates. Converting between
+ * integer widths keeps the most-significant bits.
+ *
+ * Common conversions, such as big-endian 16-bit integers to native floats,
+ * have their own constant-format kernels that compilers can vectorise. All
+ * other pairs work unspecialised.
+ * \{
+ */
+
+enum ring_buf_format {
+  RING_BUF_FMT_S16,
+  RING_BUF_FMT_S16LE,
+  RING_BUF_FMT_S16BE,
+  RING_BUF_FMT_S32,
+  RING_BUF_FMT_S32LE,
+  RING_BUF_FMT_S32BE,
+  RING_BUF_FMT_F32,
+  RING_BUF_FMT_F32LE,
+  RING_BUF_FMT_F32BE,
+};
+
+/*!
+ * \brief Size of one sample in bytes.
+ * \returns Two or four bytes.
+ */
+static inline ring_buf_size_t ring_buf_format_size(enum ring_buf_format fmt) {
+  return fmt < RING_BUF_FMT_S32 ? 2U : 4U;
+}
+
+/*!
+ * \brief Gets samples converted from one format to another.
+ * \details Gets whole samples only. A sample that straddles the end of the
+ * buffer space goes through a temporary.
+ * \param data Array of \c count samples in the \c to format.
+ * \param count Maximum number of samples to get.
+ * \param from Format of the samples in the ring buffer.
+ * \param to Format of the samples in the array.
+ * \returns Number of samples got, or negative error.
+ * \retval -EINVAL if either format is unknown.
+ */
+int ring_buf_get_convert(struct ring_buf *buf, void *data,
+                         ring_buf_size_t count, enum ring_buf_format from,
+                         enum ring_buf_format to);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,88 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_buf_convert.h"
+
+int ring_buf_convert_test(int argc, char **argv) {
+  /*
+   * Big-endian 16-bit integers convert to native floats and back.
+   */
+  {
+    RING_BUF_DEFINE(buf, 32U);
+    static const uint8_t s16be[] = {0x00, 0x00, 0x40, 0x00, 0x80, 0x00,
+                                    0x7f, 0xff, 0xc0, 0x00};
+    assert(ring_buf_put_all(&buf, s16be, sizeof(s16be)) == 0);
+    float f32[8U];
+    assert(ring_buf_get_convert(&buf, f32, 8U, RING_BUF_FMT_S16BE,
+                                RING_BUF_FMT_F32) == 5);
+    assert(f32[0] == 0.0F && f32[1] == 0.5F && f32[2] == -1.0F);
+    assert(f32[3] == 32767.0F / 32768.0F && f32[4] == -0.5F);
+    assert(ring_buf_is_empty(&buf));
+
+    static const float floats[] = {0.5F, -1.0F, 2.0F, -2.0F, 0.25F / 32768.0F};
+    assert(ring_buf_put_all(&buf, floats, sizeof(floats)) == 0);
+    int16_t s16[5U];
+    assert(ring_buf_get_convert(&buf, s16, 5U, RING_BUF_FMT_F32,
+                                RING_BUF_FMT_S16) == 5);
+    assert(s16[0] == 16384 && s16[1] == -32768);
+    assert(s16[2] == 32767 && s16[3] == -32768 && s16[4] == 0);
+
+    assert(ring_buf_get_convert(&buf, s16, 1U, RING_BUF_FMT_F32BE + 1,
+                                RING_BUF_FMT_S16) == -EINVAL);
+  }
+
+  /*
+   * Endian swaps and width changes between integers.
+   */
+  {
+    RING_BUF_DEFINE(buf, 16U);
+    static const uint8_t s32le[] = {0x78, 0x56, 0x34, 0x12,
+                                    0x00, 0x00, 0x00, 0x80};
+    assert(ring_buf_put_all(&buf, s32le, sizeof(s32le)) == 0);
+    uint8_t s16be[4U];
+    assert(ring_buf_get_convert(&buf, s16be, 2U, RING_BUF_FMT_S32LE,
+                                RING_BUF_FMT_S16BE) == 2);
+    static const uint8_t expect[] = {0x12, 0x34, 0x80, 0x00};
+    assert(memcmp(s16be, expect, sizeof(expect)) == 0);
+
+    assert(ring_buf_put_all(&buf, expect, sizeof(expect)) == 0);
+    int32_t s32[2U];
+    assert(ring_buf_get_convert(&buf, s32, 2U, RING_BUF_FMT_S16BE,
+                                RING_BUF_FMT_S32) == 2);
+    assert(s32[0] == 0x12340000 && s32[1] == INT32_MIN);
+  }
+
+  /*
+   * Samples stream through a ring of odd size, so that samples straddle the
+   * end of the buffer space. Every format round-trips from and to floats.
+   */
+  for (int from = RING_BUF_FMT_S16; from <= RING_BUF_FMT_F32BE; from++) {
+    RING_BUF_DEFINE(buf, 37U);
+    RING_BUF_DEFINE(scratch, 4U);
+    ring_buf_size_t size = ring_buf_format_size((enum ring_buf_format)from);
+    int next = 0, expect = 0;
+    for (int round = 0; round < 30; round++) {
+      while (ring_buf_free_space(&buf) >= size) {
+        float value = (float)((next % 64) - 32) / 64.0F;
+        uint8_t sample[4U];
+        assert(ring_buf_put_all(&scratch, &value, sizeof(value)) == 0);
+        assert(ring_buf_get_convert(&scratch, sample, 1U, RING_BUF_FMT_F32,
+                                    (enum ring_buf_format)from) == 1);
+        assert(ring_buf_put_all(&buf, sample, size) == 0);
+        next++;
+      }
+      float got[20U];
+      ring_buf_size_t max = round < 29 ? (ring_buf_size_t)round % 20U : 20U;
+      int count = ring_buf_get_convert(&buf, got, max,
+                                       (enum ring_buf_format)from,
+                                       RING_BUF_FMT_F32);
+      assert(count >= 0);
+      for (int index = 0; index < count; index++, expect++)
+        assert(got[index] == (float)((expect % 64) - 32) / 64.0F);
+    }
+    assert(expect == next && ring_buf_is_empty(&buf));
+  }
+
+  return EXIT_SUCCESS;
+}
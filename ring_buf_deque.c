@@ -0,0 +1,138 @@
+/*!
+ * \file ring_buf_deque.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_deque.h"
+
+#include <stdint.h>
+
+/*!
+ * \brief Answers true if a ring buffer holds a power-of-two number of slots.
+ */
+static bool ring_buf_deque_fits(const struct ring_buf *buf) {
+  ring_buf_size_t slots = buf->size / sizeof(ring_buf_atomic_t);
+  return buf->size % sizeof(ring_buf_atomic_t) == 0U && slots &&
+         (slots & (slots - 1U)) == 0U;
+}
+
+static inline struct ring_buf *
+ring_buf_deque_buf(const struct ring_buf_deque *deque) {
+  return (struct ring_buf *)(intptr_t)ring_buf_atomic_load(&deque->buf);
+}
+
+static inline ring_buf_size_t
+ring_buf_deque_slots(const struct ring_buf *buf) {
+  return buf->size / sizeof(ring_buf_atomic_t);
+}
+
+static inline ring_buf_atomic_t *ring_buf_deque_slot(const struct ring_buf *buf,
+                                                     ring_buf_atomic_t index) {
+  return (ring_buf_atomic_t *)buf->space +
+         ((ring_buf_size_t)index & (ring_buf_deque_slots(buf) - 1U));
+}
+
+int ring_buf_deque_init(struct ring_buf_deque *deque, struct ring_buf *buf) {
+  if (!ring_buf_deque_fits(buf))
+    return -EINVAL;
+  deque->top = deque->bottom = 0;
+  deque->buf = (ring_buf_atomic_t)(intptr_t)buf;
+  return 0;
+}
+
+/*
+ * Releasing the bottom publishes the task's slot to thieves that acquire the
+ * bottom.
+ */
+int ring_buf_deque_push(struct ring_buf_deque *deque, void *task) {
+  struct ring_buf *buf = ring_buf_deque_buf(deque);
+  ring_buf_atomic_t bottom = deque->bottom;
+  ring_buf_atomic_t top = ring_buf_atomic_load(&deque->top);
+  if ((ring_buf_size_t)(bottom - top) >= ring_buf_deque_slots(buf))
+    return -EMSGSIZE;
+  ring_buf_atomic_store(ring_buf_deque_slot(buf, bottom),
+                        (ring_buf_atomic_t)(intptr_t)task);
+  ring_buf_atomic_store(&deque->bottom, bottom + 1);
+  return 0;
+}
+
+/*
+ * Reserving the bottom slot before reading the top, with a full fence in
+ * between, means that a thief either sees the reservation or the owner sees
+ * the thief's top. Only the last task needs settling by compare-and-swap.
+ */
+int ring_buf_deque_pop(struct ring_buf_deque *deque, void **task) {
+  struct ring_buf *buf = ring_buf_deque_buf(deque);
+  ring_buf_atomic_t bottom = deque->bottom - 1;
+  ring_buf_atomic_store(&deque->bottom, bottom);
+  ring_buf_atomic_fence();
+  ring_buf_atomic_t top = ring_buf_atomic_load(&deque->top);
+  int err = 0;
+  if (top <= bottom) {
+    *task = (void *)(intptr_t)ring_buf_atomic_load(
+        ring_buf_deque_slot(buf, bottom));
+    if (top != bottom)
+      return 0;
+    if (!ring_buf_atomic_compare_exchange(&deque->top, &top, top + 1))
+      err = -EAGAIN;
+  } else
+    err = -EAGAIN;
+  ring_buf_atomic_store(&deque->bottom, bottom + 1);
+  return err;
+}
+
+int ring_buf_deque_steal(struct ring_buf_deque *deque, void **task) {
+  ring_buf_atomic_t top = ring_buf_atomic_load(&deque->top);
+  ring_buf_atomic_fence();
+  ring_buf_atomic_t bottom = ring_buf_atomic_load(&deque->bottom);
+  if (top >= bottom)
+    return -EAGAIN;
+  struct ring_buf *buf = ring_buf_deque_buf(deque);
+  ring_buf_atomic_t value =
+      ring_buf_atomic_load(ring_buf_deque_slot(buf, top));
+  if (!ring_buf_atomic_compare_exchange(&deque->top, &top, top + 1))
+    return -EBUSY;
+  *task = (void *)(intptr_t)value;
+  return 0;
+}
+
+/*
+ * Tasks keep their indices. Each lands in the same slot modulo the larger
+ * slot count, so thieves racing the swap find the same task in either space.
+ */
+int ring_buf_deque_grow(struct ring_buf_deque *deque, struct ring_buf *buf) {
+  if (!ring_buf_deque_fits(buf))
+    return -EINVAL;
+  struct ring_buf *old = ring_buf_deque_buf(deque);
+  ring_buf_atomic_t bottom = deque->bottom;
+  ring_buf_atomic_t top = ring_buf_atomic_load(&deque->top);
+  if ((ring_buf_size_t)(bottom - top) > ring_buf_deque_slots(buf))
+    return -EMSGSIZE;
+  for (ring_buf_atomic_t index = top; index < bottom; index++)
+    ring_buf_atomic_store(
+        ring_buf_deque_slot(buf, index),
+        ring_buf_atomic_load(ring_buf_deque_slot(old, index)));
+  ring_buf_atomic_store(&deque->buf, (ring_buf_atomic_t)(intptr_t)buf);
+  return 0;
+}
@@ -0,0 +1,113 @@
+/*!
+ * \file ring_buf_deque.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf_atomic.h"
+
+/*!
+ * \defgroup ring_buf_deque Work-Stealing Deque
+ * \ingroup ring_buf_deque
+ * \brief Chase-Lev work-stealing deque over ring buffer space.
+ * \details The deque stores pointer-sized tasks in a ring buffer's space,
+ * whose size must be a power-of-two number of slots. The ring buffer's zones
+ * play no part. One owner thread pushes and pops at the bottom; any number
+ * of thief threads steal from the top.
+ *
+ * The owner's push and pop use plain loads and releasing stores, plus one
+ * fence when popping. Only a pop that races for the last task and every
+ * steal compare-and-swap the top.
+ *
+ * A full deque grows when the owner swaps in a larger ring buffer. Thieves
+ * may still read the old space for a while afterwards: keep it alive until
+ * every thief that started stealing before the swap has finished, for
+ * instance until the next fork-join barrier.
+ * \{
+ */
+
+struct ring_buf_deque {
+  ring_buf_atomic_t top, bottom;
+  /*!
+   * \brief Current ring buffer as an integer for atomic access.
+   */
+  ring_buf_atomic_t buf;
+};
+
+/*!
+ * \brief Initialises an empty deque.
+ * \details The ring buffer's space must align for pointer-sized integers.
+ * \retval 0 on success.
+ * \retval -EINVAL if the ring buffer's size is not a power-of-two number of
+ * task slots.
+ */
+int ring_buf_deque_init(struct ring_buf_deque *deque, struct ring_buf *buf);
+
+/*!
+ * \brief Pushes a task at the bottom.
+ * \details Owner only.
+ * \retval 0 on success.
+ * \retval -EMSGSIZE if the deque is full; grow it and push again.
+ */
+int ring_buf_deque_push(struct ring_buf_deque *deque, void *task);
+
+/*!
+ * \brief Pops the most recently pushed task from the bottom.
+ * \details Owner only.
+ * \retval 0 on success.
+ * \retval -EAGAIN if the deque is empty.
+ */
+int ring_buf_deque_pop(struct ring_buf_deque *deque, void **task);
+
+/*!
+ * \brief Steals the least recently pushed task from the top.
+ * \details Any thread.
+ * \retval 0 on success.
+ * \retval -EAGAIN if the deque is empty.
+ * \retval -EBUSY if another thief or the owner took the task first; try
+ * again or elsewhere.
+ */
+int ring_buf_deque_steal(struct ring_buf_deque *deque, void **task);
+
+/*!
+ * \brief Swaps in a larger ring buffer.
+ * \details Owner only. Copies the outstanding tasks across.
+ * \retval 0 on success.
+ * \retval -EINVAL if the new size is not a power-of-two number of slots.
+ * \retval -EMSGSIZE if the new ring buffer cannot hold the outstanding tasks.
+ */
+int ring_buf_deque_grow(struct ring_buf_deque *deque, struct ring_buf *buf);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
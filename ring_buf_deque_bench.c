@@ -0,0 +1,214 @@
+/*!
+ * \file ring_buf_deque_bench.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Fork-join benchmark: the work-stealing deque against a mutex-protected
+ * deque. Each round, the owner forks a batch of tasks into its deque then
+ * joins by working through them while thieves steal from the other end.
+ *
+ *     ring_buf_deque_bench [thieves [rounds [tasks [work]]]]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ring_buf_deque.h"
+
+struct deque_ops {
+  const char *name;
+  void (*init)(void);
+  void (*push)(void *task);
+  int (*pop)(void **task);
+  int (*steal)(void **task);
+  void (*fini)(void);
+};
+
+/*
+ * Lock-free deque, growing by doubling whenever the owner's push fails.
+ */
+
+static struct ring_buf_deque deque;
+static struct ring_buf bufs[32U];
+static unsigned grown;
+
+static void lock_free_init(void) {
+  grown = 0U;
+  bufs[0].size = sizeof(ring_buf_atomic_t[64U]);
+  bufs[0].space = malloc(bufs[0].size);
+  (void)ring_buf_deque_init(&deque, &bufs[0]);
+}
+
+static void lock_free_push(void *task) {
+  while (ring_buf_deque_push(&deque, task) == -EMSGSIZE) {
+    if (grown + 1U == sizeof(bufs) / sizeof(bufs[0]) ||
+        bufs[grown].size > RING_BUF_SIZE_MAX / 2U) {
+      (void)fputs("ring_buf_deque_bench: too many tasks\n", stderr);
+      exit(EXIT_FAILURE);
+    }
+    struct ring_buf *buf = &bufs[++grown];
+    buf->size = 2U * bufs[grown - 1U].size;
+    if ((buf->space = malloc(buf->size)) == NULL) {
+      (void)fputs("ring_buf_deque_bench: out of memory\n", stderr);
+      exit(EXIT_FAILURE);
+    }
+    (void)ring_buf_deque_grow(&deque, buf);
+  }
+}
+
+static int lock_free_pop(void **task) {
+  return ring_buf_deque_pop(&deque, task);
+}
+
+static int lock_free_steal(void **task) {
+  return ring_buf_deque_steal(&deque, task);
+}
+
+static void lock_free_fini(void) {
+  for (unsigned i = 0U; i <= grown; i++)
+    free(bufs[i].space);
+}
+
+/*
+ * Mutex-protected deque over a growable array.
+ */
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static void **array;
+static size_t capacity, top, bottom;
+
+static void mutex_init(void) {
+  capacity = 64U;
+  array = malloc(capacity * sizeof(*array));
+  top = bottom = 0U;
+}
+
+static void mutex_push(void *task) {
+  (void)pthread_mutex_lock(&mutex);
+  if (bottom == capacity) {
+    for (size_t i = top; i < bottom; i++)
+      array[i - top] = array[i];
+    bottom -= top;
+    top = 0U;
+    if (bottom == capacity)
+      array = realloc(array, (capacity *= 2U) * sizeof(*array));
+  }
+  array[bottom++] = task;
+  (void)pthread_mutex_unlock(&mutex);
+}
+
+static int mutex_pop(void **task) {
+  int err = -EAGAIN;
+  (void)pthread_mutex_lock(&mutex);
+  if (top < bottom) {
+    *task = array[--bottom];
+    err = 0;
+  }
+  (void)pthread_mutex_unlock(&mutex);
+  return err;
+}
+
+static int mutex_steal(void **task) {
+  int err = -EAGAIN;
+  (void)pthread_mutex_lock(&mutex);
+  if (top < bottom) {
+    *task = array[top++];
+    err = 0;
+  }
+  (void)pthread_mutex_unlock(&mutex);
+  return err;
+}
+
+static void mutex_fini(void) { free(array); }
+
+static const struct deque_ops ops[] = {
+    {"ring_buf_deque", lock_free_init, lock_free_push, lock_free_pop,
+     lock_free_steal, lock_free_fini},
+    {"mutex deque", mutex_init, mutex_push, mutex_pop, mutex_steal,
+     mutex_fini}};
+
+static const struct deque_ops *op;
+static ring_buf_atomic_t done, stop;
+static unsigned work;
+static volatile unsigned sink;
+
+static void run(void *task) {
+  unsigned value = (unsigned)(size_t)task;
+  for (unsigned i = 0U; i < work; i++)
+    value = value * 1103515245U + 12345U;
+  sink = value;
+  (void)ring_buf_atomic_fetch_add(&done, 1);
+}
+
+static void *thief(void *arg) {
+  void *task;
+  (void)arg;
+  while (!ring_buf_atomic_load(&stop))
+    if (op->steal(&task) == 0)
+      run(task);
+  return NULL;
+}
+
+static double now(void) {
+  struct timespec ts;
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+  unsigned thieves = argc > 1 ? (unsigned)atoi(argv[1]) : 3U;
+  unsigned rounds = argc > 2 ? (unsigned)atoi(argv[2]) : 1000U;
+  unsigned tasks = argc > 3 ? (unsigned)atoi(argv[3]) : 1000U;
+  work = argc > 4 ? (unsigned)atoi(argv[4]) : 100U;
+  pthread_t *threads = malloc(thieves * sizeof(*threads));
+  for (size_t i = 0U; i < sizeof(ops) / sizeof(ops[0]); i++) {
+    op = &ops[i];
+    op->init();
+    done = stop = 0;
+    for (unsigned j = 0U; j < thieves; j++)
+      (void)pthread_create(&threads[j], NULL, thief, NULL);
+    double start = now();
+    for (unsigned round = 1U; round <= rounds; round++) {
+      for (unsigned task = 1U; task <= tasks; task++)
+        op->push((void *)(size_t)task);
+      void *task;
+      while (op->pop(&task) == 0)
+        run(task);
+      while (ring_buf_atomic_load(&done) != (ring_buf_atomic_t)round * tasks)
+        ;
+    }
+    double elapsed = now() - start;
+    ring_buf_atomic_store(&stop, 1);
+    for (unsigned j = 0U; j < thieves; j++)
+      (void)pthread_join(threads[j], NULL);
+    op->fini();
+    printf("%-16s %u thieves: %.3f s, %.1f ns per task\n", op->name, thieves,
+           elapsed, elapsed * 1e9 / ((double)rounds * tasks));
+  }
+  free(threads);
+  return EXIT_SUCCESS;
+}
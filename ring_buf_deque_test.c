@@ -0,0 +1,58 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "ring_buf_deque.h"
+
+int ring_buf_deque_test(int argc, char **argv) {
+  static ring_buf_atomic_t small_space[4U], large_space[8U], odd_space[3U];
+  struct ring_buf small = {.space = small_space, .size = sizeof(small_space)};
+  struct ring_buf large = {.space = large_space, .size = sizeof(large_space)};
+  struct ring_buf odd = {.space = odd_space, .size = sizeof(odd_space)};
+  struct ring_buf_deque deque;
+  assert(ring_buf_deque_init(&deque, &odd) == -EINVAL);
+  assert(ring_buf_deque_init(&deque, &small) == 0);
+
+  int tasks[10U];
+  void *task;
+  assert(ring_buf_deque_pop(&deque, &task) == -EAGAIN);
+  assert(ring_buf_deque_steal(&deque, &task) == -EAGAIN);
+
+  /*
+   * The owner pops last in, first out; thieves steal first in, first out.
+   */
+  for (int i = 0; i < 4; i++)
+    assert(ring_buf_deque_push(&deque, &tasks[i]) == 0);
+  assert(ring_buf_deque_push(&deque, &tasks[4]) == -EMSGSIZE);
+  assert(ring_buf_deque_steal(&deque, &task) == 0 && task == &tasks[0]);
+  assert(ring_buf_deque_pop(&deque, &task) == 0 && task == &tasks[3]);
+
+  /*
+   * Wrap around the small space, fill it, then grow and carry on.
+   */
+  for (int i = 4; i < 6; i++)
+    assert(ring_buf_deque_push(&deque, &tasks[i]) == 0);
+  assert(ring_buf_deque_push(&deque, &tasks[6]) == -EMSGSIZE);
+  assert(ring_buf_deque_grow(&deque, &odd) == -EINVAL);
+  assert(ring_buf_deque_grow(&deque, &large) == 0);
+  for (int i = 6; i < 10; i++)
+    assert(ring_buf_deque_push(&deque, &tasks[i]) == 0);
+  assert(ring_buf_deque_steal(&deque, &task) == 0 && task == &tasks[1]);
+  assert(ring_buf_deque_steal(&deque, &task) == 0 && task == &tasks[2]);
+  for (int i = 9; i >= 4; i--)
+    assert(ring_buf_deque_pop(&deque, &task) == 0 && task == &tasks[i]);
+  assert(ring_buf_deque_pop(&deque, &task) == -EAGAIN);
+  assert(ring_buf_deque_steal(&deque, &task) == -EAGAIN);
+
+  /*
+   * Popping and stealing settle the last task between them.
+   */
+  assert(ring_buf_deque_push(&deque, &tasks[0]) == 0);
+  assert(ring_buf_deque_pop(&deque, &task) == 0 && task == &tasks[0]);
+  assert(ring_buf_deque_steal(&deque, &task) == -EAGAIN);
+  assert(ring_buf_deque_push(&deque, &tasks[1]) == 0);
+  assert(ring_buf_deque_steal(&deque, &task) == 0 && task == &tasks[1]);
+  assert(ring_buf_deque_pop(&deque, &task) == -EAGAIN);
+
+  return EXIT_SUCCESS;
+}
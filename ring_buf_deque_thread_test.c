@@ -0,0 +1,83 @@
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "ring_buf_deque.h"
+
+#define TASKS 100000U
+#define THIEVES 3U
+
+static struct ring_buf_deque deque;
+static ring_buf_atomic_t runs[TASKS], done, stop;
+
+/*
+ * Each task is the address of its own run counter.
+ */
+static void run(void *task) {
+  (void)ring_buf_atomic_fetch_add(task, 1);
+  (void)ring_buf_atomic_fetch_add(&done, 1);
+}
+
+static void *thief(void *arg) {
+  void *task;
+  (void)arg;
+  while (!ring_buf_atomic_load(&stop))
+    if (ring_buf_deque_steal(&deque, &task) == 0)
+      run(task);
+    else
+      (void)sched_yield();
+  return NULL;
+}
+
+/*
+ * One owner pushes batches of varying size and pops each batch dry while
+ * thieves steal. Popping every batch down to its last task races the
+ * thieves for it, round after round. Batches outgrow the initial space;
+ * growing doubles it and keeps the old spaces alive for thieves still
+ * reading them. Every task must run exactly once.
+ *
+ * Idle thieves yield, and the owner yields every fourth round, so that
+ * stealing interleaves with popping even on a single processor.
+ */
+int ring_buf_deque_thread_test(int argc, char **argv) {
+  static struct ring_buf bufs[8U];
+  unsigned grown = 0U;
+  bufs[0].size = sizeof(ring_buf_atomic_t[4U]);
+  bufs[0].space = malloc(bufs[0].size);
+  assert(ring_buf_deque_init(&deque, &bufs[0]) == 0);
+  pthread_t threads[THIEVES];
+  for (unsigned i = 0U; i < THIEVES; i++)
+    assert(pthread_create(&threads[i], NULL, thief, NULL) == 0);
+
+  unsigned next = 0U;
+  for (unsigned round = 0U; next < TASKS; round++) {
+    unsigned batch = 1U + round * 37U % 64U;
+    for (; batch && next < TASKS; batch--, next++)
+      while (ring_buf_deque_push(&deque, &runs[next]) == -EMSGSIZE) {
+        struct ring_buf *buf = &bufs[++grown];
+        assert(grown < sizeof(bufs) / sizeof(bufs[0]));
+        buf->size = 2U * bufs[grown - 1U].size;
+        buf->space = malloc(buf->size);
+        assert(ring_buf_deque_grow(&deque, buf) == 0);
+      }
+    if (round % 4U == 0U)
+      (void)sched_yield();
+    void *task;
+    while (ring_buf_deque_pop(&deque, &task) == 0)
+      run(task);
+  }
+  while (ring_buf_atomic_load(&done) != (ring_buf_atomic_t)TASKS)
+    ;
+  ring_buf_atomic_store(&stop, 1);
+  for (unsigned i = 0U; i < THIEVES; i++)
+    assert(pthread_join(threads[i], NULL) == 0);
+
+  for (unsigned i = 0U; i < TASKS; i++)
+    assert(runs[i] == 1);
+  assert(grown > 0U);
+  for (unsigned i = 0U; i <= grown; i++)
+    free(bufs[i].space);
+  return EXIT_SUCCESS;
+}
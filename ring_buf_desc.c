@@ -0,0 +1,90 @@
+/*!
+ * \file ring_buf_desc.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_desc.h"
+
+/*
+ * The pool's return ring and the descriptor rings cross threads: the consumer
+ * frees blocks that the producer allocates again. Putting acquires the get
+ * zone's tail and releases the put zone's; getting does the reverse.
+ */
+
+static int ring_buf_desc_put_all(struct ring_buf *buf, const void *data,
+                                 ring_buf_size_t size) {
+  struct ring_buf view;
+  ring_buf_atomic_put_acquire(&view, buf);
+  int err = ring_buf_put_all(&view, data, size);
+  if (err == 0)
+    ring_buf_atomic_put_release(buf, &view);
+  return err;
+}
+
+static int ring_buf_desc_get_all(struct ring_buf *buf, void *data,
+                                 ring_buf_size_t size) {
+  struct ring_buf view;
+  ring_buf_atomic_get_acquire(&view, buf);
+  int err = ring_buf_get_all(&view, data, size);
+  if (err == 0)
+    ring_buf_atomic_get_release(buf, &view);
+  return err;
+}
+
+int ring_buf_pool_init(struct ring_buf_pool *pool, void *arena,
+                       uint32_t block_size, uint32_t count,
+                       struct ring_buf *returns) {
+  if (sizeof(uint32_t) * count > returns->size)
+    return -EMSGSIZE;
+  pool->arena = arena;
+  pool->block_size = block_size;
+  pool->free = returns;
+  ring_buf_reset(returns, 0U);
+  for (uint32_t offset = 0U; count--; offset += block_size)
+    (void)ring_buf_put_all(returns, &offset, sizeof(offset));
+  return 0;
+}
+
+void *ring_buf_pool_alloc(struct ring_buf_pool *pool,
+                          struct ring_buf_desc *desc) {
+  if (ring_buf_desc_get_all(pool->free, &desc->offset,
+                            sizeof(desc->offset)) < 0)
+    return NULL;
+  desc->length = desc->flags = desc->user = 0U;
+  return ring_buf_pool_space(pool, desc);
+}
+
+int ring_buf_pool_free(struct ring_buf_pool *pool,
+                       const struct ring_buf_desc *desc) {
+  return ring_buf_desc_put_all(pool->free, &desc->offset,
+                               sizeof(desc->offset));
+}
+
+int ring_buf_desc_put(struct ring_buf *buf, const struct ring_buf_desc *desc) {
+  return ring_buf_desc_put_all(buf, desc, sizeof(*desc));
+}
+
+int ring_buf_desc_get(struct ring_buf *buf, struct ring_buf_desc *desc) {
+  return ring_buf_desc_get_all(buf, desc, sizeof(*desc));
+}
@@ -0,0 +1,132 @@
+/*!
+ * \file ring_buf_desc.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "ring_buf_atomic.h"
+
+/*!
+ * \defgroup ring_buf_desc Ring Buffer Descriptors
+ * \ingroup ring_buf_desc
+ * \brief Zero-copy payload handoff by descriptor.
+ * \details Large payloads live in a pooled arena of fixed-size blocks. Only
+ * 16-byte descriptors pass through ring buffers, so the cost of a handoff
+ * stays the same whatever the payload size.
+ *
+ * The producer allocates a block from the pool, fills it in place and puts
+ * its descriptor on a descriptor ring. The consumer gets the descriptor,
+ * reads the payload in place and frees the block. Freeing puts the block's
+ * offset on the pool's return ring, from which the producer allocates again.
+ * Each ring has one putter and one getter; ownership of a block passes with
+ * its descriptor. The producer and the consumer may run on different threads:
+ * every put and get goes through the shared ring's acquire and release views,
+ * so a descriptor or an offset becomes visible only after its bytes.
+ * \{
+ */
+
+/*!
+ * \brief Payload descriptor.
+ * \details The offset locates the payload's block within the arena. Length,
+ * flags and user data belong to the application.
+ */
+struct ring_buf_desc {
+  uint32_t offset, length, flags, user;
+};
+
+/*!
+ * \brief Pool of payload blocks.
+ * \details The return ring holds the offsets of free blocks.
+ */
+struct ring_buf_pool {
+  uint8_t *arena;
+  uint32_t block_size;
+  struct ring_buf *free;
+};
+
+/*!
+ * \brief Initialises a pool with all its blocks free.
+ * \param arena Address of \c count blocks of \c block_size bytes.
+ * \param returns Return ring of at least \c count offsets, four bytes per
+ * block.
+ * \retval 0 on success.
+ * \retval -EMSGSIZE if the return ring cannot hold all the offsets.
+ */
+int ring_buf_pool_init(struct ring_buf_pool *pool, void *arena,
+                       uint32_t block_size, uint32_t count,
+                       struct ring_buf *returns);
+
+/*!
+ * \brief Allocates a block.
+ * \details Sets up the descriptor with the block's offset and clears its
+ * other fields.
+ * \returns Address of the block, or \c NULL if the pool has no free blocks.
+ */
+void *ring_buf_pool_alloc(struct ring_buf_pool *pool,
+                          struct ring_buf_desc *desc);
+
+/*!
+ * \brief Frees a descriptor's block.
+ * \retval 0 on success.
+ * \retval -EMSGSIZE if the return ring is full, meaning a double free.
+ */
+int ring_buf_pool_free(struct ring_buf_pool *pool,
+                       const struct ring_buf_desc *desc);
+
+/*!
+ * \brief Address of a descriptor's payload.
+ */
+static inline void *ring_buf_pool_space(const struct ring_buf_pool *pool,
+                                        const struct ring_buf_desc *desc) {
+  return pool->arena + desc->offset;
+}
+
+/*!
+ * \brief Puts a descriptor on a descriptor ring.
+ * \retval 0 on success.
+ * \retval -EMSGSIZE if the ring is full.
+ */
+int ring_buf_desc_put(struct ring_buf *buf, const struct ring_buf_desc *desc);
+
+/*!
+ * \brief Gets a descriptor from a descriptor ring.
+ * \retval 0 on success.
+ * \retval -EAGAIN if the ring is empty.
+ */
+int ring_buf_desc_get(struct ring_buf *buf, struct ring_buf_desc *desc);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,64 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_buf_desc.h"
+
+int ring_buf_desc_test(int argc, char **argv) {
+  static uint8_t arena[4U][64U];
+  RING_BUF_DEFINE(returns, sizeof(uint32_t[4U]));
+  RING_BUF_DEFINE(ring, sizeof(struct ring_buf_desc[2U]));
+  struct ring_buf_pool pool;
+  assert(sizeof(struct ring_buf_desc) == 16U);
+  assert(ring_buf_pool_init(&pool, arena, sizeof(arena[0]), 5U,
+                            &returns) == -EMSGSIZE);
+  assert(ring_buf_pool_init(&pool, arena, sizeof(arena[0]), 4U,
+                            &returns) == 0);
+
+  /*
+   * Hand off three payloads through a ring of two descriptors. The payload
+   * bytes never pass through a ring.
+   */
+  const char *messages[] = {"first", "second", "third"};
+  struct ring_buf_desc desc;
+  for (int i = 0; i < 2; i++) {
+    char *space = ring_buf_pool_alloc(&pool, &desc);
+    assert(space != NULL);
+    desc.length = (uint32_t)strlen(messages[i]);
+    desc.user = (uint32_t)i;
+    (void)memcpy(space, messages[i], desc.length);
+    assert(ring_buf_desc_put(&ring, &desc) == 0);
+  }
+  assert(ring_buf_desc_put(&ring, &desc) == -EMSGSIZE);
+  assert(ring_buf_used_space(&returns) == sizeof(uint32_t[2U]));
+
+  for (int i = 0; i < 3; i++) {
+    assert(ring_buf_desc_get(&ring, &desc) == 0);
+    assert(desc.user == (uint32_t)i);
+    assert(desc.length == strlen(messages[i]));
+    assert(memcmp(ring_buf_pool_space(&pool, &desc), messages[i],
+                  desc.length) == 0);
+    assert(ring_buf_pool_free(&pool, &desc) == 0);
+    if (i == 0) {
+      char *space = ring_buf_pool_alloc(&pool, &desc);
+      desc.length = (uint32_t)strlen(messages[2]);
+      desc.user = 2U;
+      (void)memcpy(space, messages[2], desc.length);
+      assert(ring_buf_desc_put(&ring, &desc) == 0);
+    }
+  }
+  assert(ring_buf_desc_get(&ring, &desc) == -EAGAIN);
+
+  /*
+   * Exhaust the pool. Freeing more blocks than the pool holds fails.
+   */
+  struct ring_buf_desc descs[4U];
+  for (int i = 0; i < 4; i++)
+    assert(ring_buf_pool_alloc(&pool, &descs[i]) != NULL);
+  assert(ring_buf_pool_alloc(&pool, &desc) == NULL);
+  for (int i = 0; i < 4; i++)
+    assert(ring_buf_pool_free(&pool, &descs[i]) == 0);
+  assert(ring_buf_pool_free(&pool, &descs[0]) == -EMSGSIZE);
+
+  return EXIT_SUCCESS;
+}
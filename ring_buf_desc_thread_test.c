@@ -0,0 +1,60 @@
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_buf_desc.h"
+
+#define PAYLOADS 100000U
+
+static uint32_t arena[4U][16U];
+static struct ring_buf_pool pool;
+RING_BUF_DEFINE(returns, sizeof(uint32_t[4U]));
+RING_BUF_DEFINE(ring, sizeof(struct ring_buf_desc[2U]));
+
+/*
+ * Fills each block in place with its sequence number before handing off its
+ * descriptor. Yields whenever the pool or the ring runs out.
+ */
+static void *produce(void *arg) {
+  (void)arg;
+  for (uint32_t payload = 0U; payload < PAYLOADS; payload++) {
+    struct ring_buf_desc desc;
+    uint32_t *space;
+    while ((space = ring_buf_pool_alloc(&pool, &desc)) == NULL)
+      (void)sched_yield();
+    for (size_t i = 0U; i < sizeof(arena[0]) / sizeof(*space); i++)
+      space[i] = payload;
+    desc.length = sizeof(arena[0]);
+    desc.user = payload;
+    while (ring_buf_desc_put(&ring, &desc) < 0)
+      (void)sched_yield();
+  }
+  return NULL;
+}
+
+/*
+ * The producer allocates and the consumer frees on separate threads. Every
+ * payload must arrive whole and in order.
+ */
+int ring_buf_desc_thread_test(int argc, char **argv) {
+  assert(ring_buf_pool_init(&pool, arena, sizeof(arena[0]), 4U, &returns) ==
+         0);
+  pthread_t thread;
+  assert(pthread_create(&thread, NULL, produce, NULL) == 0);
+  for (uint32_t expect = 0U; expect < PAYLOADS; expect++) {
+    struct ring_buf_desc desc;
+    while (ring_buf_desc_get(&ring, &desc) < 0)
+      (void)sched_yield();
+    assert(desc.user == expect);
+    assert(desc.length == sizeof(arena[0]));
+    const uint32_t *space = ring_buf_pool_space(&pool, &desc);
+    for (size_t i = 0U; i < sizeof(arena[0]) / sizeof(*space); i++)
+      assert(space[i] == expect);
+    assert(ring_buf_pool_free(&pool, &desc) == 0);
+  }
+  assert(pthread_join(thread, NULL) == 0);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,302 @@
+/*!
+ * \file ring_buf_gorilla.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_gorilla.h"
+
+#include <string.h>
+
+/*!
+ * \brief Marks the exclusive-or window as unset.
+ */
+#define RING_BUF_GORILLA_NO_WINDOW 32U
+
+static unsigned ring_buf_gorilla_leading(uint32_t value) {
+  unsigned leading = 0U;
+  for (uint32_t bit = UINT32_C(0x80000000); !(value & bit); bit >>= 1U)
+    leading++;
+  return leading;
+}
+
+static unsigned ring_buf_gorilla_trailing(uint32_t value) {
+  unsigned trailing = 0U;
+  for (uint32_t bit = 1U; !(value & bit); bit <<= 1U)
+    trailing++;
+  return trailing;
+}
+
+/*!
+ * \brief Writes bits, most significant first.
+ * \details Assumes zeroed bytes beyond the current bit.
+ * \param width Number of bits, at most 32.
+ */
+static void ring_buf_gorilla_write(struct ring_buf_gorilla_block *block,
+                                   uint32_t value, unsigned width) {
+  while (width) {
+    unsigned room = 8U - (block->bits & 7U);
+    unsigned take = width < room ? width : room;
+    uint32_t chunk = (value >> (width - take)) & ((1U << take) - 1U);
+    block->bytes[block->bits >> 3U] |= (uint8_t)(chunk << (room - take));
+    block->bits += take;
+    width -= take;
+  }
+}
+
+static uint32_t ring_buf_gorilla_read(struct ring_buf_gorilla_block *block,
+                                      unsigned width) {
+  uint32_t value = 0U;
+  while (width) {
+    unsigned room = 8U - (block->bits & 7U);
+    unsigned take = width < room ? width : room;
+    uint32_t byte = block->bytes[block->bits >> 3U];
+    value = (value << take) | ((byte >> (room - take)) & ((1U << take) - 1U));
+    block->bits += take;
+    width -= take;
+  }
+  return value;
+}
+
+static int32_t ring_buf_gorilla_extend(uint32_t value, unsigned width) {
+  uint32_t sign = UINT32_C(1) << (width - 1U);
+  return (int32_t)((value ^ sign) - sign);
+}
+
+/*!
+ * \brief Starts a block with a raw sample.
+ */
+static void ring_buf_gorilla_start(struct ring_buf_gorilla_block *block,
+                                   struct ring_buf_gorilla_state *state,
+                                   uint32_t value) {
+  memset(block->bytes, 0, sizeof(block->bytes));
+  block->bits = 8U;
+  ring_buf_gorilla_write(block, value, 32U);
+  state->value = value;
+  state->delta = 0U;
+  state->leading = RING_BUF_GORILLA_NO_WINDOW;
+  state->trailing = 0U;
+}
+
+static void ring_buf_gorilla_xor(struct ring_buf_gorilla_block *block,
+                                 struct ring_buf_gorilla_state *state,
+                                 uint32_t value) {
+  uint32_t xor = value ^ state->value;
+  state->value = value;
+  if (xor == 0U) {
+    ring_buf_gorilla_write(block, 0U, 1U);
+    return;
+  }
+  unsigned leading = ring_buf_gorilla_leading(xor);
+  unsigned trailing = ring_buf_gorilla_trailing(xor);
+  if (state->leading != RING_BUF_GORILLA_NO_WINDOW &&
+      leading >= state->leading && trailing >= state->trailing) {
+    ring_buf_gorilla_write(block, 2U, 2U);
+    ring_buf_gorilla_write(block, xor >> state->trailing,
+                           32U - state->leading - state->trailing);
+    return;
+  }
+  unsigned width = 32U - leading - trailing;
+  ring_buf_gorilla_write(block, 3U, 2U);
+  ring_buf_gorilla_write(block, leading, 5U);
+  ring_buf_gorilla_write(block, width - 1U, 5U);
+  ring_buf_gorilla_write(block, xor >> trailing, width);
+  state->leading = leading;
+  state->trailing = trailing;
+}
+
+static uint32_t ring_buf_gorilla_unxor(struct ring_buf_gorilla_block *block,
+                                       struct ring_buf_gorilla_state *state) {
+  if (ring_buf_gorilla_read(block, 1U)) {
+    if (ring_buf_gorilla_read(block, 1U)) {
+      state->leading = ring_buf_gorilla_read(block, 5U);
+      unsigned width = ring_buf_gorilla_read(block, 5U) + 1U;
+      state->trailing = 32U - state->leading - width;
+    }
+    unsigned width = 32U - state->leading - state->trailing;
+    state->value ^= ring_buf_gorilla_read(block, width) << state->trailing;
+  }
+  return state->value;
+}
+
+/*
+ * Deltas and their deltas wrap modulo two to the power 32. Small deltas of
+ * deltas take seven, nine or twelve bits in two's complement.
+ */
+static void ring_buf_gorilla_delta(struct ring_buf_gorilla_block *block,
+                                   struct ring_buf_gorilla_state *state,
+                                   uint32_t value) {
+  uint32_t delta = value - state->value;
+  uint32_t dod = delta - state->delta;
+  int32_t small = ring_buf_gorilla_extend(dod, 32U);
+  state->value = value;
+  state->delta = delta;
+  if (dod == 0U)
+    ring_buf_gorilla_write(block, 0U, 1U);
+  else if (small >= -64 && small < 64) {
+    ring_buf_gorilla_write(block, 2U, 2U);
+    ring_buf_gorilla_write(block, dod, 7U);
+  } else if (small >= -256 && small < 256) {
+    ring_buf_gorilla_write(block, 6U, 3U);
+    ring_buf_gorilla_write(block, dod, 9U);
+  } else if (small >= -2048 && small < 2048) {
+    ring_buf_gorilla_write(block, 14U, 4U);
+    ring_buf_gorilla_write(block, dod, 12U);
+  } else {
+    ring_buf_gorilla_write(block, 15U, 4U);
+    ring_buf_gorilla_write(block, dod, 32U);
+  }
+}
+
+static uint32_t ring_buf_gorilla_undelta(struct ring_buf_gorilla_block *block,
+                                         struct ring_buf_gorilla_state *state) {
+  static const unsigned widths[] = {7U, 9U, 12U, 32U};
+  unsigned prefix = 0U;
+  while (prefix < 4U && ring_buf_gorilla_read(block, 1U))
+    prefix++;
+  if (prefix) {
+    unsigned width = widths[prefix - 1U];
+    uint32_t dod = ring_buf_gorilla_read(block, width);
+    state->delta += (uint32_t)ring_buf_gorilla_extend(dod, width);
+  }
+  return state->value += state->delta;
+}
+
+static int ring_buf_gorilla_put(struct ring_buf_gorilla *gorilla,
+                                uint32_t value) {
+  struct ring_buf_gorilla_block *block = &gorilla->block;
+  if (block->bytes[0] == 0U) {
+    ring_buf_gorilla_start(block, &gorilla->state, value);
+    block->bytes[0] = 1U;
+    return 0;
+  }
+  struct ring_buf_gorilla_state state = gorilla->state;
+  ring_buf_size_t bits = block->bits;
+  if (gorilla->kind == RING_BUF_GORILLA_FLOAT)
+    ring_buf_gorilla_xor(block, &gorilla->state, value);
+  else
+    ring_buf_gorilla_delta(block, &gorilla->state, value);
+  if (block->bits <= 8U * (1U + RING_BUF_GORILLA_BLOCK) &&
+      block->bytes[0] < UINT8_MAX) {
+    block->bytes[0]++;
+    return 0;
+  }
+  /*
+   * Undo the overflowing sample. Flushing ignores the stray bits beyond the
+   * block's sample count.
+   */
+  gorilla->state = state;
+  block->bits = bits;
+  int err = ring_buf_gorilla_flush(gorilla);
+  if (err < 0)
+    return err;
+  return ring_buf_gorilla_put(gorilla, value);
+}
+
+void ring_buf_gorilla_init(struct ring_buf_gorilla *gorilla,
+                           struct ring_buf *buf,
+                           enum ring_buf_gorilla_kind kind) {
+  gorilla->buf = buf;
+  gorilla->kind = kind;
+  gorilla->block.bytes[0] = 0U;
+  gorilla->block.bits = 0U;
+}
+
+int ring_buf_gorilla_put_float(struct ring_buf_gorilla *gorilla, float value) {
+  uint32_t bits;
+  (void)memcpy(&bits, &value, sizeof(bits));
+  return ring_buf_gorilla_put(gorilla, bits);
+}
+
+int ring_buf_gorilla_put_int(struct ring_buf_gorilla *gorilla, int32_t value) {
+  return ring_buf_gorilla_put(gorilla, (uint32_t)value);
+}
+
+int ring_buf_gorilla_flush(struct ring_buf_gorilla *gorilla) {
+  struct ring_buf *buf = gorilla->buf;
+  struct ring_buf_gorilla_block *block = &gorilla->block;
+  if (block->bytes[0] == 0U)
+    return 0;
+  ring_buf_item_length_t length = (block->bits + 7U) >> 3U;
+  if (sizeof(length) + length > buf->size)
+    return -EMSGSIZE;
+  while (sizeof(length) + length > ring_buf_free_space(buf)) {
+    ring_buf_item_length_t drop;
+    (void)ring_buf_get_ack(buf, ring_buf_item_get(buf, NULL, &drop));
+  }
+  (void)ring_buf_put_ack(buf, ring_buf_item_put(buf, block->bytes, length));
+  block->bytes[0] = 0U;
+  return 0;
+}
+
+void ring_buf_gorilla_iter_init(struct ring_buf_gorilla_iter *iter,
+                                struct ring_buf *buf,
+                                enum ring_buf_gorilla_kind kind) {
+  iter->buf = buf;
+  iter->kind = kind;
+  iter->count = 0U;
+  iter->claim = 0U;
+}
+
+static int ring_buf_gorilla_next(struct ring_buf_gorilla_iter *iter,
+                                 uint32_t *value) {
+  struct ring_buf_gorilla_block *block = &iter->block;
+  if (iter->count == 0U) {
+    ring_buf_item_length_t length;
+    int claim = ring_buf_item_get(iter->buf, block->bytes, &length);
+    if (claim < 0)
+      return claim;
+    iter->claim += claim;
+    iter->count = block->bytes[0] - 1U;
+    block->bits = 8U;
+    iter->state.value = *value = ring_buf_gorilla_read(block, 32U);
+    iter->state.delta = 0U;
+    return 0;
+  }
+  iter->count--;
+  if (iter->kind == RING_BUF_GORILLA_FLOAT)
+    *value = ring_buf_gorilla_unxor(block, &iter->state);
+  else
+    *value = ring_buf_gorilla_undelta(block, &iter->state);
+  return 0;
+}
+
+int ring_buf_gorilla_next_float(struct ring_buf_gorilla_iter *iter,
+                                float *value) {
+  uint32_t bits;
+  int err = ring_buf_gorilla_next(iter, &bits);
+  if (err < 0)
+    return err;
+  (void)memcpy(value, &bits, sizeof(*value));
+  return 0;
+}
+
+int ring_buf_gorilla_next_int(struct ring_buf_gorilla_iter *iter,
+                              int32_t *value) {
+  uint32_t bits;
+  int err = ring_buf_gorilla_next(iter, &bits);
+  if (err < 0)
+    return err;
+  *value = (int32_t)bits;
+  return 0;
+}
@@ -0,0 +1,156 @@
+/*!
+ * \file ring_buf_gorilla.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf_item.h"
+
+/*!
+ * \defgroup ring_buf_gorilla Compressed Numeric Ring Buffer
+ * \ingroup ring_buf_gorilla
+ * \brief Gorilla-style compression of numeric samples.
+ * \details Encodes successive 32-bit samples into a byte ring buffer as a
+ * stream of bits. Floats encode as the exclusive-or of each sample with its
+ * predecessor: an unchanged sample takes one bit, and a change reuses the
+ * previous window of meaningful bits when it fits. Integers encode as the
+ * delta of their deltas: a constant rate of change takes one bit per sample.
+ * Slowly changing telemetry compresses several-fold.
+ *
+ * The encoder collects samples in blocks of at most \c RING_BUF_GORILLA_BLOCK
+ * bytes, then puts each block as one ring buffer item. Every block starts
+ * with a raw sample, so blocks decode independently. When the ring buffer
+ * fills up, putting a block drops the oldest blocks, keeping the most recent
+ * history. Samples in the encoder's open block become visible only when the
+ * block fills or after flushing.
+ *
+ * Decoding iterates the samples one at a time, block by block, claiming each
+ * block in turn. Iteration is passive: acknowledge zero afterwards to keep
+ * the samples, or the iterator's claim to consume them. Do not interleave
+ * encoding and iterating on the same ring buffer, since dropping blocks
+ * acknowledges the get zone.
+ * \{
+ */
+
+/*!
+ * \brief Maximum size of encoded samples per block in bytes.
+ */
+#define RING_BUF_GORILLA_BLOCK 64U
+
+enum ring_buf_gorilla_kind {
+  RING_BUF_GORILLA_FLOAT,
+  RING_BUF_GORILLA_INT,
+};
+
+struct ring_buf_gorilla_state {
+  uint32_t value, delta;
+  unsigned leading, trailing;
+};
+
+/*!
+ * \brief Block of encoded samples.
+ * \details The first byte counts the samples. The bytes reserve room beyond
+ * the block's limit for the largest encoded sample.
+ */
+struct ring_buf_gorilla_block {
+  uint8_t bytes[1U + RING_BUF_GORILLA_BLOCK + 8U];
+  ring_buf_size_t bits;
+};
+
+struct ring_buf_gorilla {
+  struct ring_buf *buf;
+  enum ring_buf_gorilla_kind kind;
+  struct ring_buf_gorilla_state state;
+  struct ring_buf_gorilla_block block;
+};
+
+struct ring_buf_gorilla_iter {
+  struct ring_buf *buf;
+  enum ring_buf_gorilla_kind kind;
+  struct ring_buf_gorilla_state state;
+  struct ring_buf_gorilla_block block;
+  unsigned count;
+  /*!
+   * \brief Bytes claimed by iterating so far.
+   */
+  ring_buf_size_t claim;
+};
+
+void ring_buf_gorilla_init(struct ring_buf_gorilla *gorilla,
+                           struct ring_buf *buf,
+                           enum ring_buf_gorilla_kind kind);
+
+/*!
+ * \brief Encodes one float sample.
+ * \retval 0 on success.
+ * \retval -EMSGSIZE if a full block cannot fit in the entire ring buffer.
+ */
+int ring_buf_gorilla_put_float(struct ring_buf_gorilla *gorilla, float value);
+
+/*!
+ * \brief Encodes one integer sample.
+ * \retval 0 on success.
+ * \retval -EMSGSIZE if a full block cannot fit in the entire ring buffer.
+ */
+int ring_buf_gorilla_put_int(struct ring_buf_gorilla *gorilla, int32_t value);
+
+/*!
+ * \brief Puts the open block, if any, making its samples visible.
+ * \retval 0 on success.
+ * \retval -EMSGSIZE if the block cannot fit in the entire ring buffer.
+ */
+int ring_buf_gorilla_flush(struct ring_buf_gorilla *gorilla);
+
+void ring_buf_gorilla_iter_init(struct ring_buf_gorilla_iter *iter,
+                                struct ring_buf *buf,
+                                enum ring_buf_gorilla_kind kind);
+
+/*!
+ * \brief Decodes the next float sample.
+ * \retval 0 on success.
+ * \retval -EAGAIN if no more samples.
+ */
+int ring_buf_gorilla_next_float(struct ring_buf_gorilla_iter *iter,
+                                float *value);
+
+/*!
+ * \brief Decodes the next integer sample.
+ * \retval 0 on success.
+ * \retval -EAGAIN if no more samples.
+ */
+int ring_buf_gorilla_next_int(struct ring_buf_gorilla_iter *iter,
+                              int32_t *value);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,84 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ring_buf_gorilla.h"
+
+static float temperature(int i) {
+  return 20.0F + (float)((i / 8) % 16) * 0.25F - (float)(i % 3) * 0.5F;
+}
+
+int ring_buf_gorilla_test(int argc, char **argv) {
+  {
+    RING_BUF_DEFINE(buf, 256U);
+    struct ring_buf_gorilla gorilla;
+    ring_buf_gorilla_init(&gorilla, &buf, RING_BUF_GORILLA_FLOAT);
+    for (int i = 0; i < 1000; i++)
+      assert(ring_buf_gorilla_put_float(&gorilla, temperature(i)) == 0);
+    assert(ring_buf_gorilla_flush(&gorilla) == 0);
+
+    /*
+     * Iterate the history twice: first passively, then consuming it. The
+     * history ends with the last sample put.
+     */
+    struct ring_buf_gorilla_iter iter;
+    int count = 0;
+    float value;
+    ring_buf_gorilla_iter_init(&iter, &buf, RING_BUF_GORILLA_FLOAT);
+    while (ring_buf_gorilla_next_float(&iter, &value) == 0)
+      count++;
+    assert(ring_buf_get_ack(&buf, 0U) == 0);
+    printf("%d float samples in %u bytes\n", count, (unsigned)buf.size);
+    assert(count > 3 * 256 / (int)sizeof(float));
+    ring_buf_gorilla_iter_init(&iter, &buf, RING_BUF_GORILLA_FLOAT);
+    for (int i = 1000 - count; i < 1000; i++) {
+      assert(ring_buf_gorilla_next_float(&iter, &value) == 0);
+      assert(value == temperature(i));
+    }
+    assert(ring_buf_gorilla_next_float(&iter, &value) == -EAGAIN);
+    assert(ring_buf_get_ack(&buf, iter.claim) == 0);
+    assert(ring_buf_is_empty(&buf));
+  }
+
+  {
+    RING_BUF_DEFINE(buf, 256U);
+    struct ring_buf_gorilla gorilla;
+    ring_buf_gorilla_init(&gorilla, &buf, RING_BUF_GORILLA_INT);
+    static const int32_t jumps[] = {0, 1, -64, 63, 64, -256, 255, 2047, -2048,
+                                    4096, INT32_MAX, INT32_MIN, -1};
+    uint32_t stamp = 1000U;
+    for (int i = 0; i < 13; i++)
+      assert(ring_buf_gorilla_put_int(&gorilla,
+                                      (int32_t)(stamp += jumps[i])) == 0);
+    for (int i = 0; i < 500; i++)
+      assert(ring_buf_gorilla_put_int(&gorilla, (int32_t)(stamp += 10U)) == 0);
+    assert(ring_buf_gorilla_flush(&gorilla) == 0);
+    assert(ring_buf_used_space(&buf) < sizeof(int32_t[513U]) / 8U);
+
+    struct ring_buf_gorilla_iter iter;
+    ring_buf_gorilla_iter_init(&iter, &buf, RING_BUF_GORILLA_INT);
+    int32_t value;
+    uint32_t expected = 1000U;
+    for (int i = 0; i < 13; i++) {
+      assert(ring_buf_gorilla_next_int(&iter, &value) == 0);
+      assert(value == (int32_t)(expected += jumps[i]));
+    }
+    for (int i = 0; i < 500; i++) {
+      assert(ring_buf_gorilla_next_int(&iter, &value) == 0);
+      assert(value == (int32_t)(expected += 10U));
+    }
+    assert(ring_buf_gorilla_next_int(&iter, &value) == -EAGAIN);
+  }
+
+  {
+    RING_BUF_DEFINE(buf, 8U);
+    struct ring_buf_gorilla gorilla;
+    ring_buf_gorilla_init(&gorilla, &buf, RING_BUF_GORILLA_FLOAT);
+    assert(ring_buf_gorilla_flush(&gorilla) == 0);
+    assert(ring_buf_gorilla_put_float(&gorilla, 1.0F) == 0);
+    assert(ring_buf_gorilla_put_float(&gorilla, 2.0F) == 0);
+    assert(ring_buf_gorilla_flush(&gorilla) == -EMSGSIZE);
+  }
+
+  return EXIT_SUCCESS;
+}
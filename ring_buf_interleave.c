@@ -0,0 +1,156 @@
+/*!
+ * \file ring_buf_interleave.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_interleave.h"
+
+#include <string.h>
+
+/*
+ * Fixed-size copies compile to single loads and stores, unaligned where
+ * necessary. Constant channel counts and sample sizes let the compiler unroll
+ * the inner loop and vectorise the outer one.
+ */
+static inline void ring_buf_interleave(uint8_t *space,
+                                       const void *const *planes,
+                                       ring_buf_size_t start,
+                                       ring_buf_size_t frames,
+                                       unsigned channels,
+                                       ring_buf_size_t size) {
+  for (ring_buf_size_t frame = 0U; frame < frames; frame++)
+    for (unsigned channel = 0U; channel < channels; channel++)
+      (void)memcpy(space + (frame * channels + channel) * size,
+                   (const uint8_t *)planes[channel] + (start + frame) * size,
+                   size);
+}
+
+static inline void ring_buf_deinterleave(void *const *planes,
+                                         const uint8_t *space,
+                                         ring_buf_size_t start,
+                                         ring_buf_size_t frames,
+                                         unsigned channels,
+                                         ring_buf_size_t size) {
+  for (ring_buf_size_t frame = 0U; frame < frames; frame++)
+    for (unsigned channel = 0U; channel < channels; channel++)
+      (void)memcpy((uint8_t *)planes[channel] + (start + frame) * size,
+                   space + (frame * channels + channel) * size, size);
+}
+
+#define RING_BUF_INTERLEAVE_CASE(_kernel_, _channels_, _size_)                 \
+  case (_channels_) * 16U + (_size_):                                          \
+    _kernel_(a, b, start, frames, _channels_, _size_);                         \
+    break
+
+#define RING_BUF_INTERLEAVE_KERNEL(_kernel_, _a_, _b_, _start_, _frames_,      \
+                                   _channels_, _size_)                         \
+  do {                                                                         \
+    void *a = (void *)(_a_);                                                   \
+    const void *b = (_b_);                                                     \
+    ring_buf_size_t start = (_start_), frames = (_frames_);                    \
+    switch ((_channels_) * 16U + (_size_)) {                                   \
+      RING_BUF_INTERLEAVE_CASE(_kernel_, 2U, 2U);                              \
+      RING_BUF_INTERLEAVE_CASE(_kernel_, 2U, 4U);                              \
+      RING_BUF_INTERLEAVE_CASE(_kernel_, 4U, 2U);                              \
+      RING_BUF_INTERLEAVE_CASE(_kernel_, 4U, 4U);                              \
+      RING_BUF_INTERLEAVE_CASE(_kernel_, 8U, 2U);                              \
+      RING_BUF_INTERLEAVE_CASE(_kernel_, 8U, 4U);                              \
+    default:                                                                   \
+      _kernel_(a, b, start, frames, _channels_, _size_);                       \
+    }                                                                          \
+  } while (0)
+
+static bool ring_buf_interleave_valid(unsigned channels,
+                                      ring_buf_size_t size) {
+  return channels && channels <= RING_BUF_INTERLEAVE_CHANNELS && size &&
+         size <= 8U;
+}
+
+/*
+ * Claims contiguous space and acknowledges only its whole frames. The space
+ * wraps at most once, so at most two claims plus one straddling frame cover
+ * any transfer. The straddling frame interleaves into a temporary and puts
+ * across the wrap.
+ */
+int ring_buf_put_interleave(struct ring_buf *buf, const void *const *planes,
+                            ring_buf_size_t frames, unsigned channels,
+                            ring_buf_size_t size) {
+  if (!ring_buf_interleave_valid(channels, size))
+    return -EINVAL;
+  const ring_buf_size_t frame = channels * size;
+  ring_buf_size_t room = ring_buf_free_space(buf) / frame;
+  if (frames > room)
+    frames = room;
+  ring_buf_size_t put = 0U;
+  while (put < frames) {
+    void *space;
+    ring_buf_size_t claim = ring_buf_put_claim(buf, &space,
+                                               (frames - put) * frame) /
+                            frame;
+    if (claim) {
+      RING_BUF_INTERLEAVE_KERNEL(ring_buf_interleave, space, planes, put,
+                                 claim, channels, size);
+      (void)ring_buf_put_ack(buf, claim * frame);
+      put += claim;
+    } else {
+      (void)ring_buf_put_ack(buf, 0U);
+      uint8_t temporary[RING_BUF_INTERLEAVE_CHANNELS * 8U];
+      ring_buf_interleave(temporary, planes, put, 1U, channels, size);
+      (void)ring_buf_put_all(buf, temporary, frame);
+      put++;
+    }
+  }
+  return (int)put;
+}
+
+int ring_buf_get_deinterleave(struct ring_buf *buf, void *const *planes,
+                              ring_buf_size_t frames, unsigned channels,
+                              ring_buf_size_t size) {
+  if (!ring_buf_interleave_valid(channels, size))
+    return -EINVAL;
+  const ring_buf_size_t frame = channels * size;
+  ring_buf_size_t used = ring_buf_used_space(buf) / frame;
+  if (frames > used)
+    frames = used;
+  ring_buf_size_t got = 0U;
+  while (got < frames) {
+    void *space;
+    ring_buf_size_t claim = ring_buf_get_claim(buf, &space,
+                                               (frames - got) * frame) /
+                            frame;
+    if (claim) {
+      RING_BUF_INTERLEAVE_KERNEL(ring_buf_deinterleave, planes, space, got,
+                                 claim, channels, size);
+      (void)ring_buf_get_ack(buf, claim * frame);
+      got += claim;
+    } else {
+      (void)ring_buf_get_ack(buf, 0U);
+      uint8_t temporary[RING_BUF_INTERLEAVE_CHANNELS * 8U];
+      (void)ring_buf_get_all(buf, temporary, frame);
+      ring_buf_deinterleave(planes, temporary, got, 1U, channels, size);
+      got++;
+    }
+  }
+  return (int)got;
+}
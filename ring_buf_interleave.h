@@ -0,0 +1,89 @@
+/*!
+ * \file ring_buf_interleave.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf.h"
+
+/*!
+ * \defgroup ring_buf_interleave Ring Buffer Channel Interleaving
+ * \ingroup ring_buf_interleave
+ * \brief Interleaves on put and deinterleaves on get.
+ * \details Frontends deliver interleaved frames of \e N channels, one sample
+ * per channel per frame. Signal processing wants planar arrays, one per
+ * channel. Putting interleaves planar arrays into frames and getting
+ * deinterleaves frames into planar arrays, straight from and to the ring
+ * buffer's claimed space: the format change happens within the copy that
+ * putting or getting performs anyway.
+ *
+ * Transfers move whole frames only, and acknowledge them. A frame that
+ * straddles the end of the buffer space goes through a temporary frame.
+ *
+ * Two, four and eight channels of two-byte or four-byte samples, such as
+ * 16-bit and 32-bit integers or single-precision floats, have their own
+ * constant-shape kernels that compilers can vectorise. Other channel counts
+ * up to eight and other sample sizes up to eight bytes work unspecialised.
+ * \{
+ */
+
+#define RING_BUF_INTERLEAVE_CHANNELS 8U
+
+/*!
+ * \brief Puts frames interleaved from planar arrays.
+ * \param planes Array of \c channels addresses, one planar array per channel.
+ * \param frames Number of frames to put.
+ * \param size Size of one sample in bytes.
+ * \returns Number of frames put, fewer if the buffer fills, or negative
+ * error.
+ * \retval -EINVAL if the channel count or sample size is out of range.
+ */
+int ring_buf_put_interleave(struct ring_buf *buf, const void *const *planes,
+                            ring_buf_size_t frames, unsigned channels,
+                            ring_buf_size_t size);
+
+/*!
+ * \brief Gets frames deinterleaved into planar arrays.
+ * \param planes Array of \c channels addresses, one planar array per channel.
+ * \param frames Maximum number of frames to get.
+ * \param size Size of one sample in bytes.
+ * \returns Number of frames got, or negative error.
+ * \retval -EINVAL if the channel count or sample size is out of range.
+ */
+int ring_buf_get_deinterleave(struct ring_buf *buf, void *const *planes,
+                              ring_buf_size_t frames, unsigned channels,
+                              ring_buf_size_t size);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
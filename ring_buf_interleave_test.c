@@ -0,0 +1,73 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_buf_interleave.h"
+
+int ring_buf_interleave_test(int argc, char **argv) {
+  /*
+   * Stereo 16-bit frames interleave left then right.
+   */
+  {
+    RING_BUF_DEFINE(buf, 16U);
+    static const int16_t left[] = {1, 2, 3}, right[] = {-1, -2, -3};
+    const void *planes[] = {left, right};
+    assert(ring_buf_put_interleave(&buf, planes, 3U, 2U, sizeof(int16_t)) ==
+           3);
+    int16_t frames[6U];
+    assert(ring_buf_get_all(&buf, frames, sizeof(frames)) == 0);
+    static const int16_t expect[] = {1, -1, 2, -2, 3, -3};
+    assert(memcmp(frames, expect, sizeof(expect)) == 0);
+    assert(ring_buf_put_interleave(&buf, planes, 1U, 0U, 2U) == -EINVAL);
+    assert(ring_buf_put_interleave(&buf, planes, 1U, 9U, 2U) == -EINVAL);
+    assert(ring_buf_get_deinterleave(&buf, NULL, 1U, 2U, 0U) == -EINVAL);
+  }
+
+  /*
+   * Frames stream through a ring whose size is not a multiple of any frame
+   * size, for every specialised shape and some unspecialised ones. Frames and
+   * samples straddle the end of the buffer space at varying offsets. Puts
+   * stop at a full ring; gets stop at an empty one.
+   */
+  static const unsigned channels[] = {2U, 4U, 8U, 2U, 4U, 8U, 3U, 1U};
+  static const ring_buf_size_t sizes[] = {2U, 2U, 2U, 4U, 4U, 4U, 4U, 8U};
+  for (size_t shape = 0U; shape < sizeof(sizes) / sizeof(sizes[0]); shape++) {
+    RING_BUF_DEFINE(buf, 101U);
+    unsigned count = channels[shape];
+    ring_buf_size_t size = sizes[shape];
+    uint8_t in[8U][40U * 8U], out[8U][40U * 8U];
+    const void *put_planes[8U];
+    void *get_planes[8U];
+    for (unsigned channel = 0U; channel < count; channel++) {
+      put_planes[channel] = in[channel];
+      get_planes[channel] = out[channel];
+    }
+    uint8_t next = 0U, expect = 0U;
+    for (int round = 0; round < 40; round++) {
+      ring_buf_size_t frames = 1U + (ring_buf_size_t)(round * 7) % 40U;
+      for (ring_buf_size_t frame = 0U; frame < frames; frame++)
+        for (unsigned channel = 0U; channel < count; channel++)
+          (void)memset(in[channel] + frame * size,
+                       (uint8_t)(next + frame) ^ (uint8_t)channel, size);
+      int put = ring_buf_put_interleave(&buf, put_planes, frames, count, size);
+      assert(put >= 0 && (ring_buf_size_t)put <= frames);
+      assert(ring_buf_free_space(&buf) < count * size ||
+             (ring_buf_size_t)put == frames);
+      next = (uint8_t)(next + put);
+      int got = ring_buf_get_deinterleave(&buf, get_planes,
+                                          (ring_buf_size_t)(round % 30),
+                                          count, size);
+      assert(got >= 0);
+      for (int frame = 0; frame < got; frame++, expect++)
+        for (unsigned channel = 0U; channel < count; channel++)
+          for (ring_buf_size_t byte = 0U; byte < size; byte++)
+            assert(out[channel][frame * size + byte] ==
+                   (uint8_t)(expect ^ channel));
+    }
+    int got = ring_buf_get_deinterleave(&buf, get_planes, 40U, count, size);
+    assert(got >= 0 && (uint8_t)(expect + got) == next);
+    assert(ring_buf_is_empty(&buf));
+  }
+
+  return EXIT_SUCCESS;
+}
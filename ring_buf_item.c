@@ -26,6 +26,8 @@
 
 #include "ring_buf_item.h"
 
+#include <limits.h>
+
 int ring_buf_item_put(struct ring_buf *buf, const void *item,
                       ring_buf_item_length_t length) {
   if (sizeof(length) + length > ring_buf_free_space(buf))
@@ -41,3 +43,66 @@ int ring_buf_item_get(struct ring_buf *buf, void *item,
   const ring_buf_size_t claim = ring_buf_get(buf, length, sizeof(*length));
   return claim + ring_buf_get(buf, item, *length);
 }
+
+/*!
+ * \brief Position within the header of the length's byte of given
+ * significance.
+ * \details Headers encode and decode byte by byte, so any host byte order and
+ * any alignment works.
+ */
+static inline unsigned
+ring_buf_item_wire_byte(const struct ring_buf_item_wire *wire,
+                        unsigned significance) {
+  return wire->order == RING_BUF_ITEM_BIG_ENDIAN
+             ? wire->width - 1U - significance
+             : significance;
+}
+
+int ring_buf_item_put_wire(struct ring_buf *buf,
+                           const struct ring_buf_item_wire *wire,
+                           const void *item, uint32_t length) {
+  unsigned width = wire->width;
+  if (width == 0U || width > 4U)
+    return -EINVAL;
+  if ((width < 4U && length >> (8U * width)) || length > INT_MAX - width ||
+      width + (ring_buf_size_t)length > ring_buf_free_space(buf))
+    return -EMSGSIZE;
+  uint8_t header[4U];
+  for (unsigned index = 0U; index < width; index++)
+    header[ring_buf_item_wire_byte(wire, index)] =
+        (uint8_t)(length >> (8U * index));
+  const ring_buf_size_t claim = ring_buf_put(buf, header, width);
+  return (int)(claim + ring_buf_put(buf, item, length));
+}
+
+/*
+ * Gets the header first then, finding the item incomplete or oversized,
+ * rewinds the get head to leave the header for next time. An item longer
+ * than the buffer could ever hold would otherwise answer -EAGAIN forever.
+ */
+int ring_buf_item_get_wire(struct ring_buf *buf,
+                           const struct ring_buf_item_wire *wire, void *item,
+                           uint32_t *length) {
+  unsigned width = wire->width;
+  if (width == 0U || width > 4U)
+    return -EINVAL;
+  ring_buf_size_t used = ring_buf_used_space(buf);
+  if (used < width)
+    return -EAGAIN;
+  uint8_t header[4U];
+  (void)ring_buf_get(buf, header, width);
+  uint32_t decoded = 0U;
+  for (unsigned index = 0U; index < width; index++)
+    decoded |= (uint32_t)header[ring_buf_item_wire_byte(wire, index)]
+               << (8U * index);
+  if (decoded > buf->size - width || decoded > INT_MAX - width) {
+    buf->get.head -= width;
+    return -EMSGSIZE;
+  }
+  if (used - width < decoded) {
+    buf->get.head -= width;
+    return -EAGAIN;
+  }
+  *length = decoded;
+  return (int)(width + ring_buf_get(buf, item, decoded));
+}
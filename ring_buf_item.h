@@ -62,6 +62,59 @@ int ring_buf_item_put(struct ring_buf *buf, const void *item,
 int ring_buf_item_get(struct ring_buf *buf, void *item,
                       ring_buf_item_length_t *length);
 
+/*!
+ * \brief Byte order of a wire-format item length.
+ */
+enum ring_buf_item_order {
+  RING_BUF_ITEM_LITTLE_ENDIAN,
+  RING_BUF_ITEM_BIG_ENDIAN,
+};
+
+/*!
+ * \brief Wire framing of items.
+ * \details Wire-format items carry their length in a header of one to four
+ * bytes in either byte order, regardless of the host's own. A ring buffer of
+ * wire-format items therefore matches a network framing byte for byte: a
+ * four-byte big-endian length prefix for example. The used region can go
+ * straight to a socket by scatter-gather write over a snapshot's spans, and
+ * a receiver can read straight into a ring buffer's claims and get the items
+ * in place.
+ */
+struct ring_buf_item_wire {
+  unsigned char width;
+  enum ring_buf_item_order order;
+};
+
+/*!
+ * \brief Puts a wire-format item's header and content.
+ * \note Does \e not auto-acknowledge the put claim.
+ * \returns Number of bytes claimed on success, negative on error.
+ * \retval -EINVAL if the wire width is not one to four bytes.
+ * \retval -EMSGSIZE if the length exceeds the header's range, or the buffer
+ * has insufficient space, or the claim would not fit in the return value.
+ */
+int ring_buf_item_put_wire(struct ring_buf *buf,
+                           const struct ring_buf_item_wire *wire,
+                           const void *item, uint32_t length);
+
+/*!
+ * \brief Gets a wire-format item.
+ * \details Unlike \c ring_buf_item_get, tolerates incomplete items such as
+ * partially received frames: claims nothing until the whole item arrives.
+ * \param item Address of the item, or \c NULL to skip it.
+ * \param length Address of the length of the item on success.
+ * \returns Number of bytes claimed on success, negative on error.
+ * \retval -EINVAL if the wire width is not one to four bytes.
+ * \retval -EAGAIN if the buffer does not yet hold a whole item.
+ * \retval -EMSGSIZE if the header's length exceeds what the buffer can ever
+ * hold after the header, or what the return value can represent. Claims
+ * nothing, leaving the header in place; the stream cannot make progress
+ * until the caller resynchronises it, by resetting the buffer for example.
+ */
+int ring_buf_item_get_wire(struct ring_buf *buf,
+                           const struct ring_buf_item_wire *wire, void *item,
+                           uint32_t *length);
+
 #ifdef __cplusplus
 }
 #endif
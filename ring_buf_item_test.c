@@ -1,6 +1,7 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "ring_buf_item.h"
 
@@ -29,5 +30,59 @@ int ring_buf_item_test(int argc, char **argv) {
     assert(size == sizeof(number));
   }
 
+  {
+    RING_BUF_DEFINE(buf, 16U);
+    const struct ring_buf_item_wire be32 = {4U, RING_BUF_ITEM_BIG_ENDIAN};
+    const struct ring_buf_item_wire le16 = {2U, RING_BUF_ITEM_LITTLE_ENDIAN};
+    const struct ring_buf_item_wire bad = {5U, RING_BUF_ITEM_BIG_ENDIAN};
+    assert(ring_buf_item_put_wire(&buf, &bad, "", 0U) == -EINVAL);
+    assert(ring_buf_item_put_wire(&buf, &le16, "", 0x10000U) == -EMSGSIZE);
+
+    /*
+     * The ring buffer's bytes match the wire framing exactly.
+     */
+    int ack = ring_buf_item_put_wire(&buf, &be32, "hello", 5U);
+    assert(ack == 9);
+    (void)ring_buf_put_ack(&buf, ack);
+    uint8_t wire[9U];
+    assert(ring_buf_get(&buf, wire, sizeof(wire)) == sizeof(wire));
+    assert(memcmp(wire, "\0\0\0\5hello", sizeof(wire)) == 0);
+    (void)ring_buf_get_ack(&buf, 0U);
+
+    /*
+     * Receiving frames piecemeal: incomplete items stay put.
+     */
+    RING_BUF_DEFINE(rx, 16U);
+    char item[8U];
+    uint32_t length;
+    assert(ring_buf_put_all(&rx, wire, 3U) == 0);
+    assert(ring_buf_item_get_wire(&rx, &be32, item, &length) == -EAGAIN);
+    assert(ring_buf_put_all(&rx, wire + 3U, 4U) == 0);
+    assert(ring_buf_item_get_wire(&rx, &be32, item, &length) == -EAGAIN);
+    assert(ring_buf_used_space(&rx) == 7U);
+    assert(ring_buf_put_all(&rx, wire + 7U, 2U) == 0);
+    ack = ring_buf_item_get_wire(&rx, &be32, item, &length);
+    assert(ack == 9 && length == 5U && memcmp(item, "hello", 5U) == 0);
+    (void)ring_buf_get_ack(&rx, ack);
+
+    ack = ring_buf_item_put_wire(&rx, &le16, "abc", 3U);
+    assert(ack == 5);
+    (void)ring_buf_put_ack(&rx, ack);
+    ack = ring_buf_item_get_wire(&rx, &le16, NULL, &length);
+    assert(ack == 5 && length == 3U);
+    (void)ring_buf_get_ack(&rx, ack);
+    assert(ring_buf_is_empty(&rx));
+
+    /*
+     * A header claiming more than the buffer can ever hold fails at once
+     * rather than waiting forever, and leaves the header in place.
+     */
+    const uint8_t oversized[] = {0U, 0U, 0U, 13U};
+    assert(ring_buf_put_all(&rx, oversized, sizeof(oversized)) == 0);
+    assert(ring_buf_item_get_wire(&rx, &be32, item, &length) == -EMSGSIZE);
+    assert(ring_buf_used_space(&rx) == sizeof(oversized));
+    ring_buf_reset(&rx, 0U);
+  }
+
   return rc;
 }
@@ -0,0 +1,450 @@
+/*!
+ * \file ring_buf_log.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_log.h"
+
+#include <stdint.h>
+#include <string.h>
+
+enum ring_buf_log_kind {
+  RING_BUF_LOG_LITERAL,
+  RING_BUF_LOG_INT,
+  RING_BUF_LOG_LONG,
+  RING_BUF_LOG_LLONG,
+  RING_BUF_LOG_SIZE,
+  RING_BUF_LOG_INTMAX,
+  RING_BUF_LOG_PTRDIFF,
+  RING_BUF_LOG_DOUBLE,
+  RING_BUF_LOG_LDOUBLE,
+  RING_BUF_LOG_STRING,
+  RING_BUF_LOG_POINTER,
+};
+
+/*!
+ * \brief Parses one conversion specification.
+ * \param spec Address of the character after the percent sign.
+ * \param kind Address of the argument's kind on success.
+ * \param stars Address of the number of \c * widths and precisions.
+ * \returns Address after the specification, or \c NULL if unsupported.
+ */
+static const char *ring_buf_log_spec(const char *spec,
+                                     enum ring_buf_log_kind *kind,
+                                     unsigned *stars) {
+  *stars = 0U;
+  if (*spec == '%') {
+    *kind = RING_BUF_LOG_LITERAL;
+    return spec + 1;
+  }
+  while (*spec && strchr("-+ #0", *spec))
+    spec++;
+  for (int part = 0; part < 2; part++) {
+    if (*spec == '*') {
+      ++*stars;
+      spec++;
+    } else
+      while (*spec >= '0' && *spec <= '9')
+        spec++;
+    if (part == 0 && *spec == '.')
+      spec++;
+    else
+      break;
+  }
+  char length = 0;
+  switch (*spec) {
+  case 'h':
+    spec += spec[1] == 'h' ? 2 : 1;
+    break;
+  case 'l':
+    length = spec[1] == 'l' ? (spec++, 'L') : 'l';
+    spec++;
+    break;
+  case 'L':
+  case 'z':
+  case 'j':
+  case 't':
+    length = *spec++;
+    break;
+  }
+  switch (*spec) {
+  case 'd':
+  case 'i':
+  case 'o':
+  case 'u':
+  case 'x':
+  case 'X':
+    *kind = length == 'l'   ? RING_BUF_LOG_LONG
+            : length == 'L' ? RING_BUF_LOG_LLONG
+            : length == 'z' ? RING_BUF_LOG_SIZE
+            : length == 'j' ? RING_BUF_LOG_INTMAX
+            : length == 't' ? RING_BUF_LOG_PTRDIFF
+                            : RING_BUF_LOG_INT;
+    break;
+  case 'c':
+    *kind = RING_BUF_LOG_INT;
+    break;
+  case 'f':
+  case 'F':
+  case 'e':
+  case 'E':
+  case 'g':
+  case 'G':
+  case 'a':
+  case 'A':
+    *kind = length == 'L' ? RING_BUF_LOG_LDOUBLE : RING_BUF_LOG_DOUBLE;
+    break;
+  case 's':
+    if (length)
+      return NULL;
+    *kind = RING_BUF_LOG_STRING;
+    break;
+  case 'p':
+    *kind = RING_BUF_LOG_POINTER;
+    break;
+  default:
+    return NULL;
+  }
+  return spec + 1;
+}
+
+static int ring_buf_log_parse(const char *format, unsigned char *kinds) {
+  unsigned count = 0U, stars;
+  enum ring_buf_log_kind kind;
+  for (const char *spec = format; (spec = strchr(spec, '%'));) {
+    if ((spec = ring_buf_log_spec(spec + 1, &kind, &stars)) == NULL ||
+        count + stars + 1U > RING_BUF_LOG_ARGS)
+      return -EINVAL;
+    if (kind == RING_BUF_LOG_LITERAL)
+      continue;
+    while (stars--)
+      kinds[count++] = RING_BUF_LOG_INT;
+    kinds[count++] = (unsigned char)kind;
+  }
+  return (int)count;
+}
+
+#define RING_BUF_LOG_PACK(_type_)                                              \
+  do {                                                                         \
+    _type_ value = va_arg(args, _type_);                                       \
+    if (size + sizeof(value) > RING_BUF_LOG_MAX ||                             \
+        ring_buf_put(buf, &value, sizeof(value)) < sizeof(value))              \
+      return -EMSGSIZE;                                                        \
+    size += sizeof(value);                                                     \
+  } while (0)
+
+/*!
+ * \brief Packs a record by putting its bytes.
+ * \details Claims without acknowledging, so that the caller can abandon a
+ * record that fails part way.
+ * \returns Size of the packed record, or negative error.
+ */
+static int ring_buf_log_put(struct ring_buf *buf,
+                            struct ring_buf_log_format *format,
+                            va_list args) {
+  ring_buf_atomic_t count = ring_buf_atomic_load(&format->count);
+  const unsigned char *kinds = format->kinds;
+  unsigned char parsed[RING_BUF_LOG_ARGS];
+  if (count == RING_BUF_LOG_UNPARSED || count == RING_BUF_LOG_PARSING) {
+    ring_buf_atomic_t unparsed = RING_BUF_LOG_UNPARSED;
+    if (count == RING_BUF_LOG_UNPARSED &&
+        ring_buf_atomic_compare_exchange(&format->count, &unparsed,
+                                         RING_BUF_LOG_PARSING)) {
+      count = ring_buf_log_parse(format->format, format->kinds);
+      ring_buf_atomic_store(&format->count, count);
+    } else {
+      count = ring_buf_log_parse(format->format, parsed);
+      kinds = parsed;
+    }
+  }
+  if (count < 0)
+    return (int)count;
+  if (ring_buf_put(buf, &format, sizeof(format)) < sizeof(format))
+    return -EMSGSIZE;
+  ring_buf_size_t size = sizeof(format);
+  for (ring_buf_atomic_t index = 0; index < count; index++)
+    switch (kinds[index]) {
+    case RING_BUF_LOG_INT:
+      RING_BUF_LOG_PACK(int);
+      break;
+    case RING_BUF_LOG_LONG:
+      RING_BUF_LOG_PACK(long);
+      break;
+    case RING_BUF_LOG_LLONG:
+      RING_BUF_LOG_PACK(long long);
+      break;
+    case RING_BUF_LOG_SIZE:
+      RING_BUF_LOG_PACK(size_t);
+      break;
+    case RING_BUF_LOG_INTMAX:
+      RING_BUF_LOG_PACK(intmax_t);
+      break;
+    case RING_BUF_LOG_PTRDIFF:
+      RING_BUF_LOG_PACK(ptrdiff_t);
+      break;
+    case RING_BUF_LOG_DOUBLE:
+      RING_BUF_LOG_PACK(double);
+      break;
+    case RING_BUF_LOG_LDOUBLE:
+      RING_BUF_LOG_PACK(long double);
+      break;
+    case RING_BUF_LOG_POINTER:
+      RING_BUF_LOG_PACK(void *);
+      break;
+    case RING_BUF_LOG_STRING: {
+      const char *string = va_arg(args, const char *);
+      size_t length = strlen(string);
+      uint16_t prefix = (uint16_t)length;
+      if (length > UINT16_MAX ||
+          size + sizeof(prefix) + length > RING_BUF_LOG_MAX ||
+          ring_buf_put(buf, &prefix, sizeof(prefix)) < sizeof(prefix) ||
+          ring_buf_put(buf, string, prefix) < prefix)
+        return -EMSGSIZE;
+      size += sizeof(prefix) + length;
+      break;
+    }
+    }
+  return (int)size;
+}
+
+/*
+ * Packs into a flat ring buffer over the record. Starting at index zero, its
+ * puts never wrap.
+ */
+int ring_buf_log_vpack(struct ring_buf_log_format *format, void *record,
+                       va_list args) {
+  struct ring_buf flat = {.space = record, .size = RING_BUF_LOG_MAX};
+  ring_buf_reset(&flat, 0U);
+  return ring_buf_log_put(&flat, format, args);
+}
+
+/*
+ * Packs the record straight into the producer's view as an item, length
+ * first. The length is unknown until packing ends, so a zero placeholder
+ * holds its place; rewinding the put head then overwrites the placeholder.
+ * Only the final acknowledgement commits the item, all or nothing.
+ */
+static int ring_buf_log_item(struct ring_buf *view,
+                             struct ring_buf_log_format *format,
+                             va_list args) {
+  const ring_buf_index_t start = view->put.head;
+  ring_buf_item_length_t length = 0U;
+  if (ring_buf_put(view, &length, sizeof(length)) < sizeof(length))
+    return -EMSGSIZE;
+  int size = ring_buf_log_put(view, format, args);
+  if (size < 0)
+    return size;
+  length = (ring_buf_item_length_t)size;
+  view->put.head = start;
+  (void)ring_buf_put(view, &length, sizeof(length));
+  view->put.head += length;
+  return ring_buf_put_ack(view, sizeof(length) + length);
+}
+
+/*
+ * Releasing the view stores the put tail after the record's bytes. A record
+ * that fails leaves the view unreleased, hence the ring buffer untouched.
+ */
+int ring_buf_log(struct ring_buf *buf, struct ring_buf_log_format *format,
+                 ...) {
+  struct ring_buf view;
+  va_list args;
+  ring_buf_atomic_put_acquire(&view, buf);
+  va_start(args, format);
+  int err = ring_buf_log_item(&view, format, args);
+  va_end(args);
+  if (err == 0)
+    ring_buf_atomic_put_release(buf, &view);
+  return err;
+}
+
+static int ring_buf_log_vsignal(struct ring_buf_signal *ring, bool wait,
+                                struct ring_buf_log_format *format,
+                                va_list args) {
+  struct ring_buf view;
+  int err = ring_buf_signal_put_acquire(ring, &view, wait);
+  if (err < 0)
+    return err;
+  err = ring_buf_log_item(&view, format, args);
+  ring_buf_signal_put_release(ring, err < 0 ? NULL : &view);
+  return err;
+}
+
+int ring_buf_log_signal(struct ring_buf_signal *ring,
+                        struct ring_buf_log_format *format, ...) {
+  va_list args;
+  va_start(args, format);
+  int err = ring_buf_log_vsignal(ring, false, format, args);
+  va_end(args);
+  return err;
+}
+
+int ring_buf_log_shared(struct ring_buf_signal *ring,
+                        struct ring_buf_log_format *format, ...) {
+  va_list args;
+  va_start(args, format);
+  int err = ring_buf_log_vsignal(ring, true, format, args);
+  va_end(args);
+  return err;
+}
+
+#define RING_BUF_LOG_UNPACK(_type_)                                            \
+  _type_ value;                                                                \
+  if (offset + sizeof(value) > size)                                           \
+    return -EINVAL;                                                            \
+  (void)memcpy(&value, bytes + offset, sizeof(value));                         \
+  offset += sizeof(value)
+
+#define RING_BUF_LOG_PRINT(_value_)                                            \
+  (stars == 0U   ? fprintf(file, spec, _value_)                                \
+   : stars == 1U ? fprintf(file, spec, star[0], _value_)                       \
+                 : fprintf(file, spec, star[0], star[1], _value_))
+
+int ring_buf_log_print(FILE *file, const void *record, ring_buf_size_t size) {
+  const uint8_t *bytes = record;
+  const struct ring_buf_log_format *format;
+  if (size < sizeof(format))
+    return -EINVAL;
+  (void)memcpy(&format, bytes, sizeof(format));
+  ring_buf_size_t offset = sizeof(format);
+  int total = 0, printed;
+  const char *literal = format->format, *percent;
+  while ((percent = strchr(literal, '%'))) {
+    (void)fwrite(literal, 1U, (size_t)(percent - literal), file);
+    total += (int)(percent - literal);
+    enum ring_buf_log_kind kind;
+    unsigned stars;
+    if ((literal = ring_buf_log_spec(percent + 1, &kind, &stars)) == NULL)
+      return -EINVAL;
+    char spec[32U];
+    size_t length = (size_t)(literal - percent);
+    if (length >= sizeof(spec))
+      return -EINVAL;
+    (void)memcpy(spec, percent, length);
+    spec[length] = '\0';
+    int star[2U];
+    for (unsigned index = 0U; index < stars; index++) {
+      RING_BUF_LOG_UNPACK(int);
+      star[index] = value;
+    }
+    switch (kind) {
+    case RING_BUF_LOG_LITERAL:
+      printed = fputc('%', file) == EOF ? -1 : 1;
+      break;
+    case RING_BUF_LOG_INT: {
+      RING_BUF_LOG_UNPACK(int);
+      printed = RING_BUF_LOG_PRINT(value);
+      break;
+    }
+    case RING_BUF_LOG_LONG: {
+      RING_BUF_LOG_UNPACK(long);
+      printed = RING_BUF_LOG_PRINT(value);
+      break;
+    }
+    case RING_BUF_LOG_LLONG: {
+      RING_BUF_LOG_UNPACK(long long);
+      printed = RING_BUF_LOG_PRINT(value);
+      break;
+    }
+    case RING_BUF_LOG_SIZE: {
+      RING_BUF_LOG_UNPACK(size_t);
+      printed = RING_BUF_LOG_PRINT(value);
+      break;
+    }
+    case RING_BUF_LOG_INTMAX: {
+      RING_BUF_LOG_UNPACK(intmax_t);
+      printed = RING_BUF_LOG_PRINT(value);
+      break;
+    }
+    case RING_BUF_LOG_PTRDIFF: {
+      RING_BUF_LOG_UNPACK(ptrdiff_t);
+      printed = RING_BUF_LOG_PRINT(value);
+      break;
+    }
+    case RING_BUF_LOG_DOUBLE: {
+      RING_BUF_LOG_UNPACK(double);
+      printed = RING_BUF_LOG_PRINT(value);
+      break;
+    }
+    case RING_BUF_LOG_LDOUBLE: {
+      RING_BUF_LOG_UNPACK(long double);
+      printed = RING_BUF_LOG_PRINT(value);
+      break;
+    }
+    case RING_BUF_LOG_POINTER: {
+      RING_BUF_LOG_UNPACK(void *);
+      printed = RING_BUF_LOG_PRINT(value);
+      break;
+    }
+    case RING_BUF_LOG_STRING: {
+      RING_BUF_LOG_UNPACK(uint16_t);
+      char string[RING_BUF_LOG_MAX + 1U];
+      if (offset + value > size)
+        return -EINVAL;
+      (void)memcpy(string, bytes + offset, value);
+      string[value] = '\0';
+      offset += value;
+      printed = RING_BUF_LOG_PRINT(string);
+      break;
+    }
+    }
+    if (printed < 0)
+      return printed;
+    total += printed;
+  }
+  (void)fputs(literal, file);
+  return total + (int)strlen(literal);
+}
+
+/*
+ * Gets records from the consumer's view, releasing each record's space back
+ * to the logging thread before formatting it.
+ */
+int ring_buf_log_drain(struct ring_buf *buf, FILE *file) {
+  uint8_t record[RING_BUF_LOG_MAX];
+  ring_buf_item_length_t length;
+  struct ring_buf view;
+  int claim, count = 0;
+  ring_buf_atomic_get_acquire(&view, buf);
+  while ((claim = ring_buf_item_get(&view, record, &length)) >= 0) {
+    (void)ring_buf_get_ack(&view, (ring_buf_size_t)claim);
+    ring_buf_atomic_get_release(buf, &view);
+    if (ring_buf_log_print(file, record, length) >= 0)
+      count++;
+  }
+  return count;
+}
+
+int ring_buf_log_drain_signal(struct ring_buf_signal *ring, FILE *file) {
+  uint8_t record[RING_BUF_LOG_MAX];
+  ring_buf_item_length_t length;
+  int count = 0;
+  while (ring_buf_signal_drain(ring, &length, sizeof(length)) ==
+         sizeof(length)) {
+    (void)ring_buf_signal_drain(ring, record, length);
+    if (ring_buf_log_print(file, record, length) >= 0)
+      count++;
+  }
+  return count;
+}
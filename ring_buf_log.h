@@ -0,0 +1,175 @@
+/*!
+ * \file ring_buf_log.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "ring_buf_item.h"
+#include "ring_buf_signal.h"
+
+/*!
+ * \defgroup ring_buf_log Deferred-Formatting Logger
+ * \ingroup ring_buf_log
+ * \brief Logs binary records now, formats them later.
+ * \details Logging on a hot path copies raw argument bytes rather than
+ * formatting them. Each log record is a ring buffer item holding the address
+ * of a static format descriptor followed by the packed arguments: integers
+ * and floating-point numbers at their promoted widths, strings inline with a
+ * 16-bit length. A background thread drains the ring buffer, formatting each
+ * record with \c fprintf, one conversion at a time.
+ *
+ * The first log call through a descriptor claims it with an atomic flag,
+ * parses its format string and publishes the argument kinds. Calls that
+ * arrive while parsing is under way parse privately rather than wait.
+ *
+ * Logging and draining acquire and release the ring buffer's tails, so the
+ * background thread may drain while the logging thread logs.
+ *
+ * Use one ring buffer per logging thread and have the background thread
+ * drain each in turn. Alternatively, share one signal-safe ring buffer
+ * between threads. Threads log to it one at a time, each waiting for the
+ * others rather than dropping its record; signal handlers log to it without
+ * waiting, dropping their records if contended. Either way, a record that
+ * does not fit is dropped.
+ *
+ * Logging packs each record directly into the ring buffer's claimed space,
+ * without an intermediate copy.
+ *
+ * Formats support the standard conversions with flags, width, precision and
+ * length modifiers, including \c * widths and precisions, but not \c %n.
+ * Records live only as long as the process: they refer to descriptors by
+ * address.
+ * \{
+ */
+
+/*!
+ * \brief Maximum size of a packed record in bytes, descriptor included.
+ */
+#define RING_BUF_LOG_MAX 256U
+
+/*!
+ * \brief Maximum number of arguments per format, \c * widths included.
+ */
+#define RING_BUF_LOG_ARGS 16U
+
+#define RING_BUF_LOG_UNPARSED (-1)
+#define RING_BUF_LOG_PARSING (-2)
+
+/*!
+ * \brief Static format descriptor.
+ * \details Define using \c RING_BUF_LOG_FORMAT.
+ */
+struct ring_buf_log_format {
+  const char *format;
+  /*!
+   * \brief Number of arguments once parsed, negative error if unparsable.
+   * \details Holds \c RING_BUF_LOG_UNPARSED before parsing and
+   * \c RING_BUF_LOG_PARSING during.
+   */
+  ring_buf_atomic_t count;
+  unsigned char kinds[RING_BUF_LOG_ARGS];
+};
+
+/*!
+ * \brief Defines a static format descriptor.
+ */
+#define RING_BUF_LOG_FORMAT(_name_, _format_)                                  \
+  static struct ring_buf_log_format _name_ = {                                 \
+      .format = _format_, .count = RING_BUF_LOG_UNPARSED}
+
+/*!
+ * \brief Packs a record.
+ * \param record Address of at least \c RING_BUF_LOG_MAX bytes.
+ * \returns Size of the packed record, or negative error.
+ * \retval -EINVAL if the format has too many or unsupported conversions.
+ * \retval -EMSGSIZE if the arguments exceed the maximum record size, or a
+ * string exceeds the 16-bit length limit.
+ */
+int ring_buf_log_vpack(struct ring_buf_log_format *format, void *record,
+                       va_list args);
+
+/*!
+ * \brief Logs a record to a ring buffer owned by the calling thread.
+ * \retval 0 on success.
+ * \retval -EMSGSIZE if the record does not fit.
+ */
+int ring_buf_log(struct ring_buf *buf, struct ring_buf_log_format *format,
+                 ...);
+
+/*!
+ * \brief Logs a record to a shared signal-safe ring buffer from a signal
+ * handler.
+ * \details Tries once to take the put zone; never waits for it.
+ * \retval 0 on success.
+ * \retval -EBUSY if contended, dropping the record.
+ * \retval -EMSGSIZE if the record does not fit, dropping the record.
+ * \retval -EINVAL if the format is unsupported, dropping the record.
+ */
+int ring_buf_log_signal(struct ring_buf_signal *ring,
+                        struct ring_buf_log_format *format, ...);
+
+/*!
+ * \brief Logs a record to a signal-safe ring buffer shared between threads.
+ * \details Waits for other threads logging at the same time, so contention
+ * loses no records. Never call from a signal handler.
+ * \retval 0 on success.
+ * \retval -EMSGSIZE if the record does not fit, dropping the record.
+ * \retval -EINVAL if the format is unsupported, dropping the record.
+ */
+int ring_buf_log_shared(struct ring_buf_signal *ring,
+                        struct ring_buf_log_format *format, ...);
+
+/*!
+ * \brief Formats one packed record.
+ * \returns Number of characters written, or negative on error.
+ */
+int ring_buf_log_print(FILE *file, const void *record, ring_buf_size_t size);
+
+/*!
+ * \brief Drains and formats all records logged to a ring buffer.
+ * \returns Number of records formatted.
+ */
+int ring_buf_log_drain(struct ring_buf *buf, FILE *file);
+
+/*!
+ * \brief Drains and formats all records logged to a signal-safe ring buffer.
+ * \returns Number of records formatted.
+ */
+int ring_buf_log_drain_signal(struct ring_buf_signal *ring, FILE *file);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
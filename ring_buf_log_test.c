@@ -0,0 +1,66 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_buf_log.h"
+
+RING_BUF_LOG_FORMAT(sent, "sent %d bytes to %s:%u\n");
+RING_BUF_LOG_FORMAT(mixed, "%-6s|%5.2f|%lld|%zu|%*d|%.*s|100%%\n");
+RING_BUF_LOG_FORMAT(unsupported, "%n\n");
+
+int ring_buf_log_test(int argc, char **argv) {
+  RING_BUF_DEFINE(buf, 256U);
+  FILE *file = tmpfile();
+  assert(file != NULL);
+
+  /*
+   * Log now; nothing formats until draining.
+   */
+  assert(ring_buf_log(&buf, &sent, 42, "localhost", 8080U) == 0);
+  assert(ring_buf_log(&buf, &mixed, "ab", 3.14159, 1LL << 40, (size_t)7, 4,
+                      9, 3, "xyzzy") == 0);
+  assert(ring_buf_log(&buf, &unsupported, NULL) == -EINVAL);
+  assert(!ring_buf_is_empty(&buf));
+  assert(ring_buf_log_drain(&buf, file) == 2);
+  assert(ring_buf_is_empty(&buf));
+
+  /*
+   * Shared signal-safe ring buffer.
+   */
+  struct ring_buf_signal ring;
+  ring_buf_signal_init(&ring, &buf);
+  assert(ring_buf_log_signal(&ring, &sent, -1, "remote", 1U) == 0);
+  assert(ring_buf_log_drain_signal(&ring, file) == 1);
+  assert(ring_buf_signal_drops(&ring) == 0U);
+
+  /*
+   * Oversize records do not fit.
+   */
+  char large[RING_BUF_LOG_MAX];
+  (void)memset(large, 'x', sizeof(large) - 1U);
+  large[sizeof(large) - 1U] = '\0';
+  assert(ring_buf_log(&buf, &sent, 0, large, 0U) == -EMSGSIZE);
+
+  /*
+   * Strings too long for their 16-bit length do not wrap round to fit.
+   */
+  char *huge = malloc(UINT16_MAX + 2U);
+  assert(huge != NULL);
+  (void)memset(huge, 'x', UINT16_MAX + 1U);
+  huge[UINT16_MAX + 1U] = '\0';
+  assert(ring_buf_log(&buf, &sent, 0, huge, 0U) == -EMSGSIZE);
+  free(huge);
+  assert(ring_buf_is_empty(&buf));
+
+  rewind(file);
+  char text[256U];
+  size_t length = fread(text, 1U, sizeof(text) - 1U, file);
+  text[length] = '\0';
+  (void)fclose(file);
+  assert(strcmp(text, "sent 42 bytes to localhost:8080\n"
+                      "ab    | 3.14|1099511627776|7|   9|xyz|100%\n"
+                      "sent -1 bytes to remote:1\n") == 0);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,154 @@
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ring_buf_log.h"
+
+#define RECORDS 20000U
+
+RING_BUF_LOG_FORMAT(counted, "%d %u\n");
+
+struct logger {
+  struct ring_buf *buf;
+  struct ring_buf_signal *ring;
+  int id;
+  unsigned full;
+  ring_buf_atomic_t done;
+};
+
+static void *log_records(void *arg) {
+  struct logger *logger = arg;
+  for (unsigned record = 0U; record < RECORDS; record++)
+    while (ring_buf_log(logger->buf, &counted, logger->id, record) ==
+           -EMSGSIZE)
+      (void)sched_yield();
+  ring_buf_atomic_store(&logger->done, 1);
+  return NULL;
+}
+
+/*
+ * Retries records that do not fit. Each retry counts a drop; contention must
+ * not.
+ */
+static void *log_shared(void *arg) {
+  struct logger *logger = arg;
+  for (unsigned record = 0U; record < RECORDS; record++) {
+    int err;
+    while ((err = ring_buf_log_shared(logger->ring, &counted, logger->id,
+                                      record)) != 0) {
+      assert(err == -EMSGSIZE);
+      logger->full++;
+      (void)sched_yield();
+    }
+  }
+  ring_buf_atomic_store(&logger->done, 1);
+  return NULL;
+}
+
+static void *log_held(void *arg) {
+  struct logger *logger = arg;
+  assert(ring_buf_log_shared(logger->ring, &counted, logger->id, 0U) == 0);
+  ring_buf_atomic_store(&logger->done, 1);
+  return NULL;
+}
+
+static void check(FILE *file) {
+  rewind(file);
+  unsigned next[2U] = {0U, 0U}, record;
+  int id;
+  while (fscanf(file, "%d %u\n", &id, &record) == 2) {
+    assert(id == 0 || id == 1);
+    assert(record == next[id]++);
+  }
+  assert(next[0] == RECORDS && next[1] == RECORDS);
+}
+
+/*
+ * Two threads log through the same fresh format descriptor, each to its own
+ * ring buffer, racing to parse the format. The test thread drains both as
+ * they fill. Every record must come out once, in order per thread.
+ */
+int ring_buf_log_thread_test(int argc, char **argv) {
+  RING_BUF_DEFINE(first, 128U);
+  RING_BUF_DEFINE(second, 128U);
+  struct logger loggers[2U] = {{.buf = &first, .id = 0},
+                               {.buf = &second, .id = 1}};
+  FILE *file = tmpfile();
+  assert(file != NULL);
+  pthread_t threads[2U];
+  for (int i = 0; i < 2; i++)
+    assert(pthread_create(&threads[i], NULL, log_records, &loggers[i]) == 0);
+
+  unsigned drained = 0U;
+  for (;;) {
+    bool done = ring_buf_atomic_load(&loggers[0].done) &&
+                ring_buf_atomic_load(&loggers[1].done);
+    int count = ring_buf_log_drain(&first, file) +
+                ring_buf_log_drain(&second, file);
+    drained += (unsigned)count;
+    if (done && count == 0)
+      break;
+    if (count == 0)
+      (void)sched_yield();
+  }
+  for (int i = 0; i < 2; i++)
+    assert(pthread_join(threads[i], NULL) == 0);
+  assert(drained == 2U * RECORDS);
+  assert(counted.count == 2);
+  check(file);
+  (void)fclose(file);
+
+  /*
+   * A thread logging to a shared ring buffer waits while another holds its
+   * put zone, then logs once the holder releases it.
+   */
+  RING_BUF_DEFINE(shared, 128U);
+  struct ring_buf_signal ring;
+  ring_buf_signal_init(&ring, &shared);
+  struct ring_buf view;
+  assert(ring_buf_signal_put_acquire(&ring, &view, false) == 0);
+  struct logger held = {.ring = &ring, .id = 0};
+  assert(pthread_create(&threads[0], NULL, log_held, &held) == 0);
+  for (int i = 0; i < 100; i++)
+    (void)sched_yield();
+  assert(!ring_buf_atomic_load(&held.done));
+  ring_buf_signal_put_release(&ring, &view);
+  assert(pthread_join(threads[0], NULL) == 0);
+  assert(ring_buf_atomic_used_space(&shared) != 0U);
+  assert(ring_buf_signal_drops(&ring) == 0U);
+  file = tmpfile();
+  assert(file != NULL);
+  assert(ring_buf_log_drain_signal(&ring, file) == 1);
+  (void)fclose(file);
+
+  /*
+   * Two threads log to one shared signal-safe ring buffer. They wait for
+   * each other, so the only drops are the retried records that did not fit.
+   */
+  struct logger sharers[2U] = {{.ring = &ring, .id = 0},
+                               {.ring = &ring, .id = 1}};
+  file = tmpfile();
+  assert(file != NULL);
+  for (int i = 0; i < 2; i++)
+    assert(pthread_create(&threads[i], NULL, log_shared, &sharers[i]) == 0);
+  drained = 0U;
+  for (;;) {
+    bool done = ring_buf_atomic_load(&sharers[0].done) &&
+                ring_buf_atomic_load(&sharers[1].done);
+    int count = ring_buf_log_drain_signal(&ring, file);
+    drained += (unsigned)count;
+    if (done && count == 0)
+      break;
+    if (count == 0)
+      (void)sched_yield();
+  }
+  for (int i = 0; i < 2; i++)
+    assert(pthread_join(threads[i], NULL) == 0);
+  assert(drained == 2U * RECORDS);
+  assert(ring_buf_signal_drops(&ring) == sharers[0].full + sharers[1].full);
+  check(file);
+  (void)fclose(file);
+  return EXIT_SUCCESS;
+}
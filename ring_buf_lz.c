@@ -0,0 +1,245 @@
+/*!
+ * \file ring_buf_lz.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_lz.h"
+
+#include <string.h>
+
+#define RING_BUF_LZ_STORED 0U
+#define RING_BUF_LZ_COMPRESSED 1U
+
+#define RING_BUF_LZ_MATCH 4U
+
+/*!
+ * \brief Compressed output running into a ring buffer.
+ * \details Fails once output reaches its limit or the ring buffer runs out of
+ * space. Either way, the item goes in stored instead.
+ */
+struct ring_buf_lz_sink {
+  struct ring_buf *buf;
+  ring_buf_size_t size, limit;
+  bool ok;
+};
+
+static void ring_buf_lz_emit(struct ring_buf_lz_sink *sink, const void *data,
+                             ring_buf_size_t size) {
+  if (!sink->ok)
+    return;
+  if (size > sink->limit - sink->size ||
+      ring_buf_put(sink->buf, data, size) < size)
+    sink->ok = false;
+  else
+    sink->size += size;
+}
+
+static void ring_buf_lz_emit_length(struct ring_buf_lz_sink *sink,
+                                    ring_buf_size_t length) {
+  uint8_t byte = UINT8_MAX;
+  for (; length >= UINT8_MAX; length -= UINT8_MAX)
+    ring_buf_lz_emit(sink, &byte, 1U);
+  byte = (uint8_t)length;
+  ring_buf_lz_emit(sink, &byte, 1U);
+}
+
+/*!
+ * \brief Emits one sequence: literals then an optional match.
+ * \details A token's high nibble holds the literal length, its low nibble the
+ * match length less four; fifteen in either extends the length with bytes
+ * that follow. A zero offset never occurs, hence the sequence without a match
+ * ends the item.
+ */
+static void ring_buf_lz_sequence(struct ring_buf_lz_sink *sink,
+                                 const uint8_t *literals,
+                                 ring_buf_size_t literal, uint16_t offset,
+                                 ring_buf_size_t match) {
+  uint8_t token = (uint8_t)((literal < 15U ? literal : 15U) << 4U);
+  if (offset)
+    token |= (uint8_t)(match - RING_BUF_LZ_MATCH < 15U
+                           ? match - RING_BUF_LZ_MATCH
+                           : 15U);
+  ring_buf_lz_emit(sink, &token, 1U);
+  if (literal >= 15U)
+    ring_buf_lz_emit_length(sink, literal - 15U);
+  ring_buf_lz_emit(sink, literals, literal);
+  if (offset == 0U)
+    return;
+  uint8_t bytes[2] = {(uint8_t)offset, (uint8_t)(offset >> 8U)};
+  ring_buf_lz_emit(sink, bytes, sizeof(bytes));
+  if (match - RING_BUF_LZ_MATCH >= 15U)
+    ring_buf_lz_emit_length(sink, match - RING_BUF_LZ_MATCH - 15U);
+}
+
+static unsigned ring_buf_lz_hash(const uint8_t *at) {
+  uint32_t word;
+  (void)memcpy(&word, at, sizeof(word));
+  return (word * UINT32_C(2654435761)) >> (32U - RING_BUF_LZ_HASH_BITS);
+}
+
+static void ring_buf_lz_compress(struct ring_buf_lz *lz,
+                                 struct ring_buf_lz_sink *sink,
+                                 const uint8_t *in, ring_buf_size_t length) {
+  ring_buf_size_t at = 0U, anchor = 0U;
+  (void)memset(lz->table, 0xff, sizeof(lz->table));
+  while (sink->ok && at + RING_BUF_LZ_MATCH <= length) {
+    unsigned hash = ring_buf_lz_hash(in + at);
+    ring_buf_size_t from = lz->table[hash];
+    lz->table[hash] = (uint16_t)at;
+    if (from >= at || memcmp(in + from, in + at, RING_BUF_LZ_MATCH) != 0) {
+      at++;
+      continue;
+    }
+    ring_buf_size_t match = RING_BUF_LZ_MATCH;
+    while (at + match < length && in[from + match] == in[at + match])
+      match++;
+    ring_buf_lz_sequence(sink, in + anchor, at - anchor,
+                         (uint16_t)(at - from), match);
+    anchor = at += match;
+  }
+  if (anchor < length)
+    ring_buf_lz_sequence(sink, in + anchor, length - anchor, 0U, 0U);
+}
+
+/*
+ * Compresses straight into the ring buffer after room for the item's header,
+ * then rewinds the put head to write the header. Rewinding within the claimed
+ * put zone only revisits bytes already claimed.
+ */
+int ring_buf_lz_put(struct ring_buf_lz *lz, struct ring_buf *buf,
+                    const void *item, ring_buf_item_length_t length) {
+  const ring_buf_index_t head = buf->put.head;
+  uint8_t header[sizeof(ring_buf_item_length_t) + 1U +
+                 sizeof(ring_buf_item_length_t)] = {0};
+  ring_buf_item_length_t size;
+  if (length >= RING_BUF_LZ_MIN &&
+      ring_buf_put(buf, header, sizeof(header)) == sizeof(header)) {
+    struct ring_buf_lz_sink sink = {
+        .buf = buf, .size = 0U, .limit = length - 3U, .ok = true};
+    ring_buf_lz_compress(lz, &sink, item, length);
+    if (sink.ok) {
+      const ring_buf_index_t tail = buf->put.head;
+      size = (ring_buf_item_length_t)(1U + sizeof(length) + sink.size);
+      (void)memcpy(header, &size, sizeof(size));
+      header[sizeof(size)] = RING_BUF_LZ_COMPRESSED;
+      (void)memcpy(header + sizeof(size) + 1U, &length, sizeof(length));
+      buf->put.head = head;
+      (void)ring_buf_put(buf, header, sizeof(header));
+      buf->put.head = tail;
+      return (int)(tail - head);
+    }
+  }
+  buf->put.head = head;
+  size = (ring_buf_item_length_t)(1U + length);
+  if (length > UINT16_MAX - 1U ||
+      sizeof(size) + size > ring_buf_free_space(buf))
+    return -EMSGSIZE;
+  header[sizeof(size)] = RING_BUF_LZ_STORED;
+  (void)memcpy(header, &size, sizeof(size));
+  ring_buf_size_t claim = ring_buf_put(buf, header, sizeof(size) + 1U);
+  return claim + ring_buf_put(buf, item, length);
+}
+
+static ring_buf_size_t ring_buf_lz_get_length(struct ring_buf *buf,
+                                              ring_buf_size_t *size) {
+  ring_buf_size_t length = 0U;
+  uint8_t byte;
+  do {
+    if (*size == 0U)
+      break;
+    (void)ring_buf_get(buf, &byte, 1U);
+    --*size;
+    length += byte;
+  } while (byte == UINT8_MAX);
+  return length;
+}
+
+/*!
+ * \brief Decompresses an item's remaining bytes from the ring buffer.
+ * \param size Number of compressed bytes.
+ * \param length Original length of the item.
+ */
+static int ring_buf_lz_decompress(struct ring_buf *buf, uint8_t *out,
+                                  ring_buf_size_t size,
+                                  ring_buf_size_t length) {
+  ring_buf_size_t at = 0U;
+  while (size) {
+    uint8_t token;
+    (void)ring_buf_get(buf, &token, 1U);
+    size--;
+    ring_buf_size_t literal = token >> 4U;
+    if (literal == 15U)
+      literal += ring_buf_lz_get_length(buf, &size);
+    if (literal > size || literal > length - at)
+      return -EINVAL;
+    (void)ring_buf_get(buf, out + at, literal);
+    size -= literal;
+    at += literal;
+    if (size == 0U)
+      break;
+    uint8_t bytes[2];
+    if (size < sizeof(bytes))
+      return -EINVAL;
+    (void)ring_buf_get(buf, bytes, sizeof(bytes));
+    size -= sizeof(bytes);
+    ring_buf_size_t offset = bytes[0] | (ring_buf_size_t)bytes[1] << 8U;
+    ring_buf_size_t match = (token & 0x0fU) + RING_BUF_LZ_MATCH;
+    if (match == 15U + RING_BUF_LZ_MATCH)
+      match += ring_buf_lz_get_length(buf, &size);
+    if (offset == 0U || offset > at || match > length - at)
+      return -EINVAL;
+    for (const uint8_t *from = out + at - offset; match--; at++)
+      out[at] = *from++;
+  }
+  return at == length ? 0 : -EINVAL;
+}
+
+/*
+ * A corrupt item rewinds the get head to where it started, leaving the
+ * caller's claim as it was and the corrupt item first in line.
+ */
+int ring_buf_lz_get(struct ring_buf *buf, void *item,
+                    ring_buf_item_length_t *length) {
+  if (ring_buf_is_empty(buf))
+    return -EAGAIN;
+  const ring_buf_index_t head = buf->get.head;
+  ring_buf_item_length_t size;
+  uint8_t flag;
+  ring_buf_size_t claim = ring_buf_get(buf, &size, sizeof(size));
+  claim += ring_buf_get(buf, &flag, 1U);
+  if (flag == RING_BUF_LZ_STORED) {
+    *length = size - 1U;
+    return claim + ring_buf_get(buf, item, *length);
+  }
+  claim += ring_buf_get(buf, length, sizeof(*length));
+  size -= 1U + sizeof(*length);
+  if (item == NULL)
+    return claim + ring_buf_get(buf, NULL, size);
+  int err = ring_buf_lz_decompress(buf, item, size, *length);
+  if (err < 0) {
+    buf->get.head = head;
+    return err;
+  }
+  return (int)(claim + size);
+}
@@ -0,0 +1,95 @@
+/*!
+ * \file ring_buf_lz.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf_item.h"
+
+/*!
+ * \defgroup ring_buf_lz Compressed Ring Buffer Items
+ * \ingroup ring_buf_lz
+ * \brief Items compressed on put and decompressed lazily on get.
+ * \details Compresses each item with a small built-in LZ77 compressor, in the
+ * style of LZ4's block format, straight into the ring buffer. Compressed
+ * items remain ordinary ring buffer items whose payloads begin with a flag
+ * byte: zero for a stored item, one for a compressed item followed by its
+ * original length. Items too small or too random to shrink go in stored.
+ *
+ * Getting decompresses only when the consumer asks for the item's bytes.
+ * Getting with a null item address skips the item, compressed or not, and
+ * still answers its original length.
+ *
+ * Compression needs a hash table of recent positions. The caller owns the
+ * table, either statically or on the stack, so compression allocates nothing.
+ * \{
+ */
+
+#define RING_BUF_LZ_HASH_BITS 10U
+
+/*!
+ * \brief Items smaller than this go in stored.
+ */
+#define RING_BUF_LZ_MIN 16U
+
+struct ring_buf_lz {
+  uint16_t table[1U << RING_BUF_LZ_HASH_BITS];
+};
+
+/*!
+ * \brief Puts an item, compressing it where that saves space.
+ * \note Does \e not acknowledge the put claim.
+ * \returns Number of bytes to acknowledge on success, negative on error.
+ * \retval -EMSGSIZE if the buffer has insufficient space for the item even
+ * after compression.
+ */
+int ring_buf_lz_put(struct ring_buf_lz *lz, struct ring_buf *buf,
+                    const void *item, ring_buf_item_length_t length);
+
+/*!
+ * \brief Gets an item, decompressing if required.
+ * \param item Address of the item, or \c NULL to skip the item without
+ * decompressing it. Reserve space for the largest possible original item.
+ * \param length Address of the item's original length on success.
+ * \returns Number of bytes to acknowledge on success, negative on error.
+ * \retval -EAGAIN if the buffer is empty.
+ * \retval -EINVAL if the compressed item is corrupt. The get zone's claim
+ * stays as it was before the call. Skip the corrupt item by getting it again
+ * with a \c NULL item, then acknowledging.
+ */
+int ring_buf_lz_get(struct ring_buf *buf, void *item,
+                    ring_buf_item_length_t *length);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,114 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_buf_lz.h"
+
+static const char text[] =
+    "GET /index.html 200 1234 ms=5\n"
+    "GET /index.html 200 1234 ms=6\n"
+    "GET /styles.css 200 4321 ms=5\n"
+    "GET /index.html 304 0 ms=1\n"
+    "GET /index.html 200 1234 ms=5\n"
+    "GET /index.html 200 1234 ms=7\n"
+    "GET /styles.css 200 4321 ms=4\n"
+    "GET /index.html 200 1234 ms=5\n";
+
+int ring_buf_lz_test(int argc, char **argv) {
+  struct ring_buf_lz lz;
+  char item[256U];
+  ring_buf_item_length_t length;
+  int ack;
+
+  {
+    RING_BUF_DEFINE(buf, 224U);
+    assert(ring_buf_lz_get(&buf, item, &length) == -EAGAIN);
+
+    /*
+     * The text exceeds the entire buffer but fits once compressed, twice.
+     */
+    assert(sizeof(text) > buf.size);
+    for (int i = 0; i < 2; i++) {
+      ack = ring_buf_lz_put(&lz, &buf, text, sizeof(text));
+      assert(ack > 0);
+      assert(ring_buf_put_ack(&buf, ack) == 0);
+    }
+    printf("%u bytes compressed to %d\n", (unsigned)sizeof(text), ack);
+    assert(ring_buf_lz_put(&lz, &buf, text, sizeof(text)) == -EMSGSIZE);
+    assert(ring_buf_put_ack(&buf, 0U) == 0);
+
+    ack = ring_buf_lz_get(&buf, NULL, &length);
+    assert(ack > 0 && length == sizeof(text));
+    assert(ring_buf_get_ack(&buf, ack) == 0);
+    (void)memset(item, 0, sizeof(item));
+    ack = ring_buf_lz_get(&buf, item, &length);
+    assert(ack > 0 && length == sizeof(text));
+    assert(memcmp(item, text, sizeof(text)) == 0);
+    assert(ring_buf_get_ack(&buf, ack) == 0);
+    assert(ring_buf_is_empty(&buf));
+
+    /*
+     * Compressed items wrap around the end of the buffer space.
+     */
+    for (int i = 0; i < 4; i++) {
+      assert(ring_buf_put_ack(&buf, ring_buf_lz_put(&lz, &buf, text,
+                                                    sizeof(text))) == 0);
+      (void)memset(item, 0, sizeof(item));
+      ack = ring_buf_lz_get(&buf, item, &length);
+      assert(ack > 0 && length == sizeof(text));
+      assert(memcmp(item, text, sizeof(text)) == 0);
+      assert(ring_buf_get_ack(&buf, ack) == 0);
+    }
+  }
+
+  {
+    RING_BUF_DEFINE(buf, 256U);
+    uint8_t noise[64U];
+    for (ring_buf_size_t i = 0U; i < sizeof(noise); i++)
+      noise[i] = (uint8_t)(i * 97U + (i >> 2U) * 13U);
+    ack = ring_buf_lz_put(&lz, &buf, noise, sizeof(noise));
+    assert(ack == 2 + 1 + (int)sizeof(noise));
+    assert(ring_buf_put_ack(&buf, ack) == 0);
+    ack = ring_buf_lz_put(&lz, &buf, "short", 6U);
+    assert(ack == 2 + 1 + 6);
+    assert(ring_buf_put_ack(&buf, ack) == 0);
+
+    ack = ring_buf_lz_get(&buf, item, &length);
+    assert(length == sizeof(noise));
+    assert(memcmp(item, noise, sizeof(noise)) == 0);
+    assert(ring_buf_get_ack(&buf, ack) == 0);
+    ack = ring_buf_lz_get(&buf, item, &length);
+    assert(length == 6U && strcmp(item, "short") == 0);
+    assert(ring_buf_get_ack(&buf, ack) == 0);
+  }
+
+  /*
+   * A corrupt compressed item, its match reaching back before the start,
+   * leaves the get zone unclaimed. Skipping it reaches the next item.
+   */
+  {
+    RING_BUF_DEFINE(buf, 64U);
+    static const uint8_t corrupt[] = {1U, 0x1fU, 'x', 1U, 0U};
+    ring_buf_item_length_t size = 1U + sizeof(length) + sizeof(corrupt);
+    length = 8U;
+    assert(ring_buf_put_all(&buf, &size, sizeof(size)) == 0);
+    assert(ring_buf_put_all(&buf, "\1", 1U) == 0);
+    assert(ring_buf_put_all(&buf, &length, sizeof(length)) == 0);
+    assert(ring_buf_put_all(&buf, corrupt, sizeof(corrupt)) == 0);
+    assert(ring_buf_put_ack(&buf, ring_buf_lz_put(&lz, &buf, "next", 5U)) ==
+           0);
+    ring_buf_size_t used = ring_buf_used_space(&buf);
+    assert(ring_buf_lz_get(&buf, item, &length) == -EINVAL);
+    assert(ring_buf_used_space(&buf) == used);
+    assert(ring_buf_lz_get(&buf, item, &length) == -EINVAL);
+    ack = ring_buf_lz_get(&buf, NULL, &length);
+    assert(ack == (int)(sizeof(size) + size));
+    assert(ring_buf_get_ack(&buf, ack) == 0);
+    ack = ring_buf_lz_get(&buf, item, &length);
+    assert(length == 5U && strcmp(item, "next") == 0);
+    assert(ring_buf_get_ack(&buf, ack) == 0);
+  }
+
+  return EXIT_SUCCESS;
+}
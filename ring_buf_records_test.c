@@ -0,0 +1,39 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ring_buf.h"
+
+struct record {
+  float x, y, z;
+};
+
+int ring_buf_records_test(int argc, char **argv) {
+  /*
+   * The buffer space is not a multiple of the record size. Three whole
+   * records fit; the fourth never partially copies.
+   */
+  RING_BUF_DEFINE(buf, sizeof(struct record[3U]) + 4U);
+  struct record records[4U], got[4U];
+  for (int i = 0; i < 4; i++)
+    records[i] = (struct record){(float)i, (float)i * 2.0F, (float)i * 3.0F};
+  assert(ring_buf_put_records(&buf, records, sizeof(*records), 4U) == 3U);
+  assert(ring_buf_used_space(&buf) == sizeof(struct record[3U]));
+  assert(ring_buf_put_records(&buf, records, sizeof(*records), 1U) == 0U);
+  assert(ring_buf_free_space(&buf) == 4U);
+
+  assert(ring_buf_get_records(&buf, got, sizeof(*got), 2U) == 2U);
+  assert(got[1].z == 3.0F);
+
+  /*
+   * Records now wrap around the end of the buffer space.
+   */
+  assert(ring_buf_put_records(&buf, records + 2, sizeof(*records), 2U) == 2U);
+  assert(ring_buf_get_records(&buf, got, sizeof(*got), 4U) == 3U);
+  assert(got[0].x == 2.0F && got[1].y == 4.0F && got[2].z == 9.0F);
+  assert(ring_buf_is_empty(&buf));
+  assert(ring_buf_get_records(&buf, NULL, sizeof(*got), 1U) == 0U);
+  assert(ring_buf_get_records(&buf, NULL, 0U, 1U) == 0U);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,122 @@
+/*!
+ * \file ring_buf_reserve.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_reserve.h"
+
+void ring_buf_reserve_init(struct ring_buf_reserve *reserve,
+                           struct ring_buf *buf) {
+  reserve->buf = buf;
+  reserve->done = 0U;
+  reserve->first = reserve->count = 0U;
+}
+
+/*!
+ * \brief Opens a reservation in the next slot.
+ */
+static int ring_buf_reserve_open(struct ring_buf_reserve *reserve,
+                                 ring_buf_size_t size) {
+  unsigned slot = (reserve->first + reserve->count++) % RING_BUF_RESERVE_MAX;
+  reserve->sizes[slot] = size;
+  return (int)slot;
+}
+
+/*!
+ * \brief Answers true if a ticket is outstanding and not yet done.
+ */
+static bool ring_buf_reserve_outstanding(const struct ring_buf_reserve *reserve,
+                                         int ticket) {
+  unsigned slot = (unsigned)ticket;
+  return ticket >= 0 && slot < RING_BUF_RESERVE_MAX &&
+         (slot - reserve->first) % RING_BUF_RESERVE_MAX < reserve->count &&
+         !(reserve->done & (UINT64_C(1) << slot));
+}
+
+/*!
+ * \brief Marks a ticket done, then releases the completed prefix.
+ * \details Releasing advances the zone's tail but not its head.
+ */
+static int ring_buf_reserve_done(struct ring_buf_reserve *reserve,
+                                 struct ring_buf_zone *zone, int ticket) {
+  if (!ring_buf_reserve_outstanding(reserve, ticket))
+    return -EINVAL;
+  uint64_t bit = UINT64_C(1) << ticket;
+  reserve->done |= bit;
+  ring_buf_size_t release = 0U;
+  while (reserve->count &&
+         (reserve->done & (bit = UINT64_C(1) << reserve->first))) {
+    reserve->done &= ~bit;
+    release += reserve->sizes[reserve->first];
+    reserve->first = (reserve->first + 1U) % RING_BUF_RESERVE_MAX;
+    reserve->count--;
+  }
+  zone->tail += release;
+  return (int)release;
+}
+
+int ring_buf_reserve_get_claim(struct ring_buf_reserve *reserve, void **space,
+                               ring_buf_size_t *size) {
+  if (reserve->count == RING_BUF_RESERVE_MAX)
+    return -EBUSY;
+  ring_buf_size_t claim = ring_buf_get_claim(reserve->buf, space, *size);
+  if (claim == 0U)
+    return -EAGAIN;
+  *size = claim;
+  return ring_buf_reserve_open(reserve, claim);
+}
+
+int ring_buf_reserve_get_ack(struct ring_buf_reserve *reserve, int ticket) {
+  return ring_buf_reserve_done(reserve, &reserve->buf->get, ticket);
+}
+
+int ring_buf_reserve_put_claim(struct ring_buf_reserve *reserve, void **space,
+                               ring_buf_size_t *size) {
+  if (reserve->count == RING_BUF_RESERVE_MAX)
+    return -EBUSY;
+  ring_buf_size_t claim = ring_buf_put_claim(reserve->buf, space, *size);
+  if (claim == 0U)
+    return -EAGAIN;
+  *size = claim;
+  return ring_buf_reserve_open(reserve, claim);
+}
+
+int ring_buf_reserve_put_ack(struct ring_buf_reserve *reserve, int ticket) {
+  return ring_buf_reserve_done(reserve, &reserve->buf->put, ticket);
+}
+
+/*
+ * The newest reservation ends at the put zone's head. Rewinding the head
+ * frees its space.
+ */
+int ring_buf_reserve_put_cancel(struct ring_buf_reserve *reserve, int ticket) {
+  if (!ring_buf_reserve_outstanding(reserve, ticket))
+    return -EINVAL;
+  unsigned last = (reserve->first + reserve->count - 1U) % RING_BUF_RESERVE_MAX;
+  if ((unsigned)ticket != last)
+    return -EBUSY;
+  reserve->buf->put.head -= reserve->sizes[last];
+  reserve->count--;
+  return 0;
+}
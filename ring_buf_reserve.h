@@ -0,0 +1,126 @@
+/*!
+ * \file ring_buf_reserve.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf.h"
+
+/*!
+ * \defgroup ring_buf_reserve Ring Buffer Reservations
+ * \ingroup ring_buf_reserve
+ * \brief Many outstanding claims, completed in any order.
+ * \details A reservation tracker sits over one zone of a ring buffer. Each
+ * reservation claims contiguous space as usual and answers a ticket, its slot
+ * in a ring of up to 64 reservations. Completing a ticket sets its bit in a
+ * completion bitmap. The zone's tail then advances over the longest prefix of
+ * completed reservations, leaving the head and with it the later
+ * reservations untouched. Capacity returns as soon as the oldest reservations
+ * complete, however late the newer ones run.
+ *
+ * On the put side, many asynchronous fills can run at once straight into the
+ * buffer space, direct memory access for example. The consumer sees the
+ * filled bytes only up to the first incomplete reservation. The newest
+ * reservation alone may be cancelled since cancelling any other would leave
+ * a hole in the byte stream.
+ *
+ * Use one tracker per zone. Do not mix tracked claims with plain claims or
+ * acknowledgements on the same zone.
+ * \{
+ */
+
+#define RING_BUF_RESERVE_MAX 64U
+
+struct ring_buf_reserve {
+  struct ring_buf *buf;
+  uint64_t done;
+  unsigned first, count;
+  ring_buf_size_t sizes[RING_BUF_RESERVE_MAX];
+};
+
+void ring_buf_reserve_init(struct ring_buf_reserve *reserve,
+                           struct ring_buf *buf);
+
+/*!
+ * \brief Reserves contiguous used space for getting.
+ * \param space Address of the reserved space on success.
+ * \param size Address of the number of bytes wanted on entry, answering the
+ * number of bytes reserved. Contiguity and used space limit the reservation.
+ * \returns Ticket for completion, or negative error.
+ * \retval -EAGAIN if the buffer holds no more unreserved bytes.
+ * \retval -EBUSY if \c RING_BUF_RESERVE_MAX reservations remain outstanding.
+ */
+int ring_buf_reserve_get_claim(struct ring_buf_reserve *reserve, void **space,
+                               ring_buf_size_t *size);
+
+/*!
+ * \brief Completes a get reservation.
+ * \details Releases the reserved space, and that of any reservations
+ * completed after it, once all the reservations before it complete.
+ * \returns Number of bytes released to the putter, or negative error.
+ * \retval -EINVAL if the ticket is not outstanding.
+ */
+int ring_buf_reserve_get_ack(struct ring_buf_reserve *reserve, int ticket);
+
+/*!
+ * \brief Reserves contiguous free space for putting.
+ * \param size Address of the number of bytes wanted on entry, answering the
+ * number of bytes reserved. Contiguity and free space limit the reservation.
+ * \returns Ticket for completion, or negative error.
+ * \retval -EAGAIN if the buffer has no more unreserved space.
+ * \retval -EBUSY if \c RING_BUF_RESERVE_MAX reservations remain outstanding.
+ */
+int ring_buf_reserve_put_claim(struct ring_buf_reserve *reserve, void **space,
+                               ring_buf_size_t *size);
+
+/*!
+ * \brief Completes a put reservation.
+ * \details Publishes the reserved space, and that of any reservations
+ * completed after it, once all the reservations before it complete.
+ * \returns Number of bytes published to the getter, or negative error.
+ * \retval -EINVAL if the ticket is not outstanding.
+ */
+int ring_buf_reserve_put_ack(struct ring_buf_reserve *reserve, int ticket);
+
+/*!
+ * \brief Cancels a put reservation.
+ * \details Returns the reserved space to the free space.
+ * \retval 0 on success.
+ * \retval -EINVAL if the ticket is not outstanding.
+ * \retval -EBUSY if the ticket is not the newest reservation.
+ */
+int ring_buf_reserve_put_cancel(struct ring_buf_reserve *reserve, int ticket);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,100 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_buf_reserve.h"
+
+int ring_buf_reserve_test(int argc, char **argv) {
+  RING_BUF_DEFINE(buf, 16U);
+  struct ring_buf_reserve reserve;
+  ring_buf_reserve_init(&reserve, &buf);
+  const char data[] = "abcdefghijkl";
+  assert(ring_buf_put_all(&buf, data, 12U) == 0);
+
+  /*
+   * Reserve three records of four bytes, then complete them out of order.
+   */
+  int tickets[3U];
+  for (int i = 0; i < 3; i++) {
+    void *space;
+    ring_buf_size_t size = 4U;
+    tickets[i] = ring_buf_reserve_get_claim(&reserve, &space, &size);
+    assert(tickets[i] >= 0 && size == 4U);
+    assert(*(char *)space == data[4 * i]);
+  }
+  ring_buf_size_t size = 4U;
+  assert(ring_buf_reserve_get_claim(&reserve, NULL, &size) == -EAGAIN);
+  assert(ring_buf_free_space(&buf) == 4U);
+  assert(ring_buf_reserve_get_ack(&reserve, tickets[1]) == 0);
+  assert(ring_buf_reserve_get_ack(&reserve, tickets[1]) == -EINVAL);
+  assert(ring_buf_reserve_get_ack(&reserve, tickets[2]) == 0);
+  assert(ring_buf_free_space(&buf) == 4U);
+  assert(ring_buf_reserve_get_ack(&reserve, tickets[0]) == 12);
+  assert(ring_buf_free_space(&buf) == 16U);
+  assert(ring_buf_reserve_get_ack(&reserve, tickets[0]) == -EINVAL);
+
+  /*
+   * Reservations wrap around the ticket ring.
+   */
+  int first = -1;
+  for (int i = 0; i < 11; i++) {
+    assert(ring_buf_put_all(&buf, "x", 1U) == 0);
+    size = 1U;
+    int ticket = ring_buf_reserve_get_claim(&reserve, NULL, &size);
+    assert(ticket >= 0 && size == 1U);
+    if (first < 0)
+      first = ticket;
+    else
+      assert(ring_buf_reserve_get_ack(&reserve, ticket) == 0);
+  }
+  assert(ring_buf_reserve_get_ack(&reserve, first) == 11);
+  assert(ring_buf_free_space(&buf) == 16U);
+
+  /*
+   * At most 64 reservations remain outstanding.
+   */
+  RING_BUF_DEFINE(large, 2U * RING_BUF_RESERVE_MAX);
+  ring_buf_reserve_init(&reserve, &large);
+  for (unsigned i = 0U; i < 2U * RING_BUF_RESERVE_MAX; i++)
+    assert(ring_buf_put_all(&large, "x", 1U) == 0);
+  for (unsigned i = 0U; i < RING_BUF_RESERVE_MAX; i++) {
+    size = 1U;
+    assert(ring_buf_reserve_get_claim(&reserve, NULL, &size) >= 0);
+  }
+  size = 1U;
+  assert(ring_buf_reserve_get_claim(&reserve, NULL, &size) == -EBUSY);
+
+  /*
+   * Three fills in flight. The getter sees nothing until the first completes.
+   * Only the newest reservation cancels.
+   */
+  RING_BUF_DEFINE(fill, 16U);
+  ring_buf_reserve_init(&reserve, &fill);
+  void *spaces[3U];
+  for (int i = 0; i < 3; i++) {
+    size = 5U;
+    tickets[i] = ring_buf_reserve_put_claim(&reserve, &spaces[i], &size);
+    assert(tickets[i] >= 0 && size == 5U);
+  }
+  size = 5U;
+  int last = ring_buf_reserve_put_claim(&reserve, NULL, &size);
+  assert(last >= 0 && size == 1U);
+  assert(ring_buf_reserve_put_claim(&reserve, NULL, &size) == -EAGAIN);
+  assert(ring_buf_reserve_put_cancel(&reserve, last) == 0);
+  assert(ring_buf_reserve_put_cancel(&reserve, tickets[1]) == -EBUSY);
+  assert(ring_buf_free_space(&fill) == 1U);
+  (void)memcpy(spaces[1], "fghij", 5U);
+  assert(ring_buf_reserve_put_ack(&reserve, tickets[1]) == 0);
+  assert(ring_buf_is_empty(&fill));
+  (void)memcpy(spaces[0], "abcde", 5U);
+  assert(ring_buf_reserve_put_ack(&reserve, tickets[0]) == 10);
+  assert(ring_buf_used_space(&fill) == 10U);
+  assert(ring_buf_reserve_put_cancel(&reserve, tickets[2]) == 0);
+  assert(ring_buf_reserve_put_cancel(&reserve, tickets[2]) == -EINVAL);
+  assert(ring_buf_free_space(&fill) == 6U);
+  char got[10U];
+  assert(ring_buf_get_all(&fill, got, sizeof(got)) == 0);
+  assert(memcmp(got, "abcdefghij", sizeof(got)) == 0);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,84 @@
+/*!
+ * \file ring_buf_select.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_select.h"
+
+int ring_buf_select_init(struct ring_buf_select *select,
+                         struct ring_buf *const *bufs, unsigned count) {
+  if (count > RING_BUF_SELECT_MAX)
+    return -EINVAL;
+  select->bufs = bufs;
+  select->count = count;
+  select->event = 0U;
+  select->waiters = 0;
+  select->wait = NULL;
+  select->wake = NULL;
+  return 0;
+}
+
+/*
+ * Polling acquires the tails that producers and consumers publish on other
+ * threads, so that a poll after a signal sees the signalled change.
+ */
+uint32_t ring_buf_select_poll(const struct ring_buf_select *select,
+                              int events) {
+  uint32_t ready = 0U;
+  for (unsigned index = 0U; index < select->count; index++) {
+    const struct ring_buf *buf = select->bufs[index];
+    if (((events & RING_BUF_SELECT_GET) && ring_buf_atomic_used_space(buf)) ||
+        ((events & RING_BUF_SELECT_PUT) && ring_buf_atomic_free_space(buf)))
+      ready |= UINT32_C(1) << index;
+  }
+  return ready;
+}
+
+/*
+ * Registering as a waiter before snapshotting the event and polling pairs with
+ * the signaller's fence between acknowledging and reading the waiter count.
+ * Either the poll sees the acknowledgement or the signaller sees the waiter
+ * and moves the event on, in which case the wait hook returns at once.
+ */
+uint32_t ring_buf_select_wait(struct ring_buf_select *select, int events) {
+  uint32_t ready;
+  (void)ring_buf_atomic_fetch_add(&select->waiters, 1);
+  for (;;) {
+    uint32_t event = ring_buf_atomic32_load(&select->event);
+    if ((ready = ring_buf_select_poll(select, events)) || select->wait == NULL)
+      break;
+    select->wait(select, event);
+  }
+  (void)ring_buf_atomic_fetch_add(&select->waiters, -1);
+  return ready;
+}
+
+void ring_buf_select_signal(struct ring_buf_select *select) {
+  ring_buf_atomic_fence();
+  if (ring_buf_atomic_load(&select->waiters) == 0)
+    return;
+  (void)ring_buf_atomic32_fetch_add(&select->event, 1U);
+  if (select->wake)
+    select->wake(select);
+}
@@ -0,0 +1,127 @@
+/*!
+ * \file ring_buf_select.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf_atomic.h"
+
+/*!
+ * \defgroup ring_buf_select Ring Buffer Selection
+ * \ingroup ring_buf_select
+ * \brief Waits on many ring buffers at once.
+ * \details A selector spans a set of up to 32 ring buffers. Polling answers a
+ * readiness bitmap, one bit per ring buffer by index: non-empty for getting,
+ * non-full for putting. Polling acquires the zones' tails atomically since
+ * other threads publish them.
+ *
+ * Waiting uses one shared event word, an "event count," for the whole set.
+ * The waiter snapshots the event, polls and, finding nothing ready, blocks
+ * until the event moves on. Producers or consumers signal the selector after
+ * acknowledging. Signalling only writes the shared word when some thread
+ * actually waits; otherwise it only reads the waiter count, and signallers on
+ * different rings do not contend.
+ *
+ * The selector stays operating system agnostic. Blocking and waking go
+ * through two hooks: a Linux futex on the event word, a Windows
+ * \c WaitOnAddress or an RTOS event flag for example. The event word is an
+ * unsigned 32-bit integer, the width that futexes wait on. Without a wait hook,
+ * waiting degrades to a single poll.
+ * \{
+ */
+
+#define RING_BUF_SELECT_MAX 32U
+
+/*!
+ * \brief Selects ring buffers that have data to get.
+ */
+#define RING_BUF_SELECT_GET 0x01
+
+/*!
+ * \brief Selects ring buffers that have space to put.
+ */
+#define RING_BUF_SELECT_PUT 0x02
+
+struct ring_buf_select {
+  struct ring_buf *const *bufs;
+  unsigned count;
+  uint32_t event;
+  ring_buf_atomic_t waiters;
+  /*!
+   * \brief Blocks while the selector's event equals the given event.
+   * \details May return spuriously.
+   */
+  void (*wait)(struct ring_buf_select *select, uint32_t event);
+  /*!
+   * \brief Wakes all threads blocked on the selector's event.
+   */
+  void (*wake)(struct ring_buf_select *select);
+};
+
+/*!
+ * \brief Initialises a selector.
+ * \details Clears the hooks. Assign them afterwards for blocking waits.
+ * \param bufs Array of ring buffer addresses.
+ * \param count Number of ring buffers.
+ * \retval 0 on success.
+ * \retval -EINVAL if \c count exceeds \c RING_BUF_SELECT_MAX.
+ */
+int ring_buf_select_init(struct ring_buf_select *select,
+                         struct ring_buf *const *bufs, unsigned count);
+
+/*!
+ * \brief Polls the selected ring buffers without waiting.
+ * \param events Bitwise-or of \c RING_BUF_SELECT_GET and \c
+ * RING_BUF_SELECT_PUT.
+ * \returns Readiness bitmap where bit \e i corresponds to ring buffer \e i.
+ */
+uint32_t ring_buf_select_poll(const struct ring_buf_select *select,
+                              int events);
+
+/*!
+ * \brief Waits until at least one ring buffer becomes ready.
+ * \returns Non-zero readiness bitmap, or zero if the selector has no wait hook
+ * and nothing is ready.
+ */
+uint32_t ring_buf_select_wait(struct ring_buf_select *select, int events);
+
+/*!
+ * \brief Signals a change to waiting selectors.
+ * \details Call after acknowledging a put or a get on any of the selector's
+ * ring buffers.
+ */
+void ring_buf_select_signal(struct ring_buf_select *select);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,51 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ring_buf_select.h"
+
+RING_BUF_DEFINE(buf0, 4U);
+RING_BUF_DEFINE(buf1, 4U);
+RING_BUF_DEFINE(buf2, 4U);
+
+static int waits;
+
+/*
+ * Simulates a producer on another thread: the first wait puts into the last
+ * ring buffer and signals the selector.
+ */
+static void wait_put(struct ring_buf_select *select, uint32_t event) {
+  assert(event == select->event);
+  waits++;
+  assert(ring_buf_put_all(&buf2, "x", 1U) == 0);
+  ring_buf_select_signal(select);
+  assert(select->event == event + 1U);
+}
+
+int ring_buf_select_test(int argc, char **argv) {
+  struct ring_buf *const bufs[] = {&buf0, &buf1, &buf2};
+  struct ring_buf_select select;
+  assert(ring_buf_select_init(&select, bufs, RING_BUF_SELECT_MAX + 1U) ==
+         -EINVAL);
+  assert(ring_buf_select_init(&select, bufs, 3U) == 0);
+
+  assert(ring_buf_select_poll(&select, RING_BUF_SELECT_GET) == 0U);
+  assert(ring_buf_select_poll(&select, RING_BUF_SELECT_PUT) == 0x07U);
+  assert(ring_buf_select_wait(&select, RING_BUF_SELECT_GET) == 0U);
+
+  assert(ring_buf_put_all(&buf1, "abcd", 4U) == 0);
+  ring_buf_select_signal(&select);
+  assert(select.event == 0U);
+  assert(ring_buf_select_poll(&select, RING_BUF_SELECT_GET) == 0x02U);
+  assert(ring_buf_select_poll(&select, RING_BUF_SELECT_PUT) == 0x05U);
+  assert(ring_buf_select_poll(&select, RING_BUF_SELECT_GET |
+                                           RING_BUF_SELECT_PUT) == 0x07U);
+  assert(ring_buf_get_all(&buf1, NULL, 4U) == 0);
+
+  select.wait = wait_put;
+  assert(ring_buf_select_wait(&select, RING_BUF_SELECT_GET) == 0x04U);
+  assert(waits == 1);
+  assert(select.waiters == 0);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+/*!
+ * \file ring_buf_seqlock.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_seqlock.h"
+#include "ring_buf_wait.h"
+
+#include <string.h>
+
+/*
+ * Stream positions count bytes from initialisation, the same as the ring
+ * buffer's own put zone which resets to index zero. A position's offset within
+ * the buffer space is therefore the ring buffer's own offset of that index.
+ */
+
+void ring_buf_seqlock_init(struct ring_buf_seqlock *seqlock,
+                           struct ring_buf *buf) {
+  seqlock->buf = buf;
+  seqlock->head = seqlock->tail = 0;
+  ring_buf_reset(buf, 0);
+}
+
+/*
+ * The fence orders the head's store before the overwriting stores. Readers
+ * that see any overwritten byte therefore see the new head.
+ */
+void ring_buf_seqlock_put(struct ring_buf_seqlock *seqlock, const void *data,
+                          ring_buf_size_t size) {
+  struct ring_buf *buf = seqlock->buf;
+  if (size > buf->size) {
+    data = (const uint8_t *)data + (size - buf->size);
+    size = buf->size;
+  }
+  ring_buf_index_t tail = seqlock->tail;
+  ring_buf_atomic_index_store(&seqlock->head, tail + size);
+  ring_buf_atomic_fence();
+  ring_buf_size_t free = ring_buf_free_space(buf);
+  if (size > free)
+    (void)ring_buf_get_all(buf, NULL, size - free);
+  (void)ring_buf_put_all(buf, data, size);
+  ring_buf_atomic_index_store(&seqlock->tail, tail + size);
+}
+
+int ring_buf_seqlock_try_read(const struct ring_buf_seqlock *seqlock,
+                              void *data, ring_buf_size_t size) {
+  const struct ring_buf *buf = seqlock->buf;
+  ring_buf_index_t tail = ring_buf_atomic_index_load(&seqlock->tail);
+  if (size > tail)
+    size = (ring_buf_size_t)tail;
+  if (size > buf->size)
+    size = buf->size;
+  ring_buf_index_t start = tail - size;
+  ring_buf_size_t offset = ring_buf_offset(buf, start);
+  ring_buf_size_t first = buf->size - offset;
+  if (first > size)
+    first = size;
+  (void)memcpy(data, (const uint8_t *)buf->space + offset, first);
+  (void)memcpy((uint8_t *)data + first, buf->space, size - first);
+  ring_buf_atomic_fence();
+  ring_buf_index_t head = ring_buf_atomic_index_load(&seqlock->head);
+  if (head - start > buf->size)
+    return -EAGAIN;
+  return (int)size;
+}
+
+ring_buf_size_t ring_buf_seqlock_read(const struct ring_buf_seqlock *seqlock,
+                                      void *data, ring_buf_size_t size) {
+  int read;
+  while ((read = ring_buf_seqlock_try_read(seqlock, data, size)) < 0)
+    ring_buf_wait_pause();
+  return read;
+}
@@ -0,0 +1,100 @@
+/*!
+ * \file ring_buf_seqlock.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf_atomic.h"
+
+/*!
+ * \defgroup ring_buf_seqlock Sequence-Locked Ring Buffer
+ * \ingroup ring_buf_seqlock
+ * \brief Consistent snapshots of an overwriting ring buffer.
+ * \details One writer puts into the ring buffer in overwrite mode, dropping
+ * the oldest bytes to make room, like a flight recorder. Any number of readers
+ * copy the latest bytes without stopping the writer: a lossy "tail -f" view.
+ *
+ * The writer publishes two stream positions: its head before copying and its
+ * tail after. A reader loads the tail, copies the window of bytes before it,
+ * then loads the head. If the head has since run more than one buffer size
+ * beyond the window's start, the writer has lapped the window and the reader
+ * tries again. The writer takes no locks and never counts readers.
+ *
+ * The writer owns the ring buffer outright; do not put or get directly.
+ * Readers copy bytes that the writer might be overwriting at the same time.
+ * Validation discards such copies, but the reads themselves race, as in any
+ * sequence lock.
+ * \{
+ */
+
+struct ring_buf_seqlock {
+  struct ring_buf *buf;
+  ring_buf_index_t head, tail;
+};
+
+/*!
+ * \brief Initialises a sequence-locked ring buffer.
+ * \details Resets the ring buffer.
+ */
+void ring_buf_seqlock_init(struct ring_buf_seqlock *seqlock,
+                           struct ring_buf *buf);
+
+/*!
+ * \brief Puts bytes, overwriting the oldest if necessary.
+ * \details Only the last buffer size of bytes survive if \c size exceeds the
+ * ring buffer's entire size.
+ */
+void ring_buf_seqlock_put(struct ring_buf_seqlock *seqlock, const void *data,
+                          ring_buf_size_t size);
+
+/*!
+ * \brief Tries once to copy the latest bytes.
+ * \param data Address of at least \c size bytes.
+ * \param size Maximum number of bytes to copy.
+ * \returns Number of bytes copied, the most recent ones; or negative on error.
+ * \retval -EAGAIN if the writer lapped the window while copying.
+ */
+int ring_buf_seqlock_try_read(const struct ring_buf_seqlock *seqlock,
+                              void *data, ring_buf_size_t size);
+
+/*!
+ * \brief Copies the latest bytes, retrying until consistent.
+ * \details Pauses the processor between tries.
+ * \returns Number of bytes copied, the most recent ones.
+ */
+ring_buf_size_t ring_buf_seqlock_read(const struct ring_buf_seqlock *seqlock,
+                                      void *data, ring_buf_size_t size);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
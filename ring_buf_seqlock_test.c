@@ -0,0 +1,42 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_buf_seqlock.h"
+
+int ring_buf_seqlock_test(int argc, char **argv) {
+  RING_BUF_DEFINE(buf, 16U);
+  struct ring_buf_seqlock seqlock;
+  ring_buf_seqlock_init(&seqlock, &buf);
+  char window[32U];
+  assert(ring_buf_seqlock_read(&seqlock, window, sizeof(window)) == 0U);
+
+  ring_buf_seqlock_put(&seqlock, "abc", 3U);
+  assert(ring_buf_seqlock_read(&seqlock, window, sizeof(window)) == 3U);
+  assert(memcmp(window, "abc", 3U) == 0);
+
+  /*
+   * Overwrite repeatedly. The latest bytes wrap around the end of the space.
+   */
+  for (int i = 0; i < 10; i++)
+    ring_buf_seqlock_put(&seqlock, "0123456789", 10U);
+  assert(ring_buf_seqlock_read(&seqlock, window, 4U) == 4U);
+  assert(memcmp(window, "6789", 4U) == 0);
+  assert(ring_buf_seqlock_read(&seqlock, window, sizeof(window)) == 16U);
+  assert(memcmp(window, "4567890123456789", 16U) == 0);
+  ring_buf_seqlock_put(&seqlock, "the quick brown fox", 19U);
+  assert(ring_buf_seqlock_read(&seqlock, window, sizeof(window)) == 16U);
+  assert(memcmp(window, " quick brown fox", 16U) == 0);
+
+  /*
+   * Simulate a writer part way through putting: its head runs ahead of its
+   * tail. Windows that the put overwrites fail; older bytes still succeed.
+   */
+  seqlock.head += 4;
+  assert(ring_buf_seqlock_try_read(&seqlock, window, 16U) == -EAGAIN);
+  assert(ring_buf_seqlock_try_read(&seqlock, window, 12U) == 12U);
+  assert(memcmp(window, "ck brown fox", 12U) == 0);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+/*!
+ * \file ring_buf_series.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_series.h"
+
+static ring_buf_size_t
+ring_buf_series_capacity(const struct ring_buf_series *series) {
+  return series->times.size / sizeof(ring_buf_series_time_t);
+}
+
+/*!
+ * \brief Slot of an entry within the buffer spaces.
+ * \details Claiming nothing from the get zone answers the address of its head
+ * without advancing it, wrapped into the buffer space. The head addresses the
+ * oldest entry.
+ */
+static ring_buf_size_t ring_buf_series_slot(struct ring_buf_series *series,
+                                            ring_buf_size_t index) {
+  void *space;
+  (void)ring_buf_get_claim(&series->times, &space, 0U);
+  ring_buf_size_t slot = (ring_buf_series_time_t *)space -
+                         (ring_buf_series_time_t *)series->times.space + index;
+  ring_buf_size_t capacity = ring_buf_series_capacity(series);
+  return slot >= capacity ? slot - capacity : slot;
+}
+
+static void ring_buf_series_spans(struct ring_buf_span spans[2], void *space,
+                                  ring_buf_size_t slot, ring_buf_size_t count,
+                                  ring_buf_size_t capacity,
+                                  ring_buf_size_t size) {
+  ring_buf_size_t first = capacity - slot;
+  if (first > count)
+    first = count;
+  spans[0].space = (uint8_t *)space + slot * size;
+  spans[0].size = first * size;
+  spans[1].space = space;
+  spans[1].size = (count - first) * size;
+}
+
+void ring_buf_series_init(struct ring_buf_series *series,
+                          ring_buf_series_time_t *times, void *records,
+                          ring_buf_size_t count, ring_buf_size_t record_size) {
+  series->times.space = times;
+  series->times.size = count * sizeof(*times);
+  series->records.space = records;
+  series->records.size = count * record_size;
+  series->record_size = record_size;
+  ring_buf_reset(&series->times, 0);
+  ring_buf_reset(&series->records, 0);
+}
+
+int ring_buf_series_put(struct ring_buf_series *series,
+                        ring_buf_series_time_t time, const void *record) {
+  ring_buf_size_t count = ring_buf_series_count(series);
+  if (count && time < ring_buf_series_time(series, count - 1U))
+    return -EINVAL;
+  if (ring_buf_is_full(&series->times)) {
+    (void)ring_buf_get_all(&series->times, NULL, sizeof(time));
+    (void)ring_buf_get_all(&series->records, NULL, series->record_size);
+  }
+  (void)ring_buf_put_all(&series->times, &time, sizeof(time));
+  (void)ring_buf_put_all(&series->records, record, series->record_size);
+  return 0;
+}
+
+ring_buf_series_time_t ring_buf_series_time(struct ring_buf_series *series,
+                                            ring_buf_size_t index) {
+  ring_buf_size_t slot = ring_buf_series_slot(series, index);
+  return ((const ring_buf_series_time_t *)series->times.space)[slot];
+}
+
+ring_buf_size_t ring_buf_series_find(struct ring_buf_series *series,
+                                     ring_buf_series_time_t time) {
+  ring_buf_size_t low = 0U, high = ring_buf_series_count(series);
+  while (low < high) {
+    ring_buf_size_t middle = low + (high - low) / 2U;
+    if (ring_buf_series_time(series, middle) < time)
+      low = middle + 1U;
+    else
+      high = middle;
+  }
+  return low;
+}
+
+int ring_buf_series_view(struct ring_buf_series *series, ring_buf_size_t index,
+                         ring_buf_size_t count, struct ring_buf_span records[2],
+                         struct ring_buf_span times[2]) {
+  ring_buf_size_t capacity = ring_buf_series_capacity(series);
+  ring_buf_size_t available = ring_buf_series_count(series);
+  if (index > available)
+    index = available;
+  if (count > available - index)
+    count = available - index;
+  ring_buf_size_t slot = ring_buf_series_slot(series, index);
+  ring_buf_series_spans(records, series->records.space, slot, count, capacity,
+                        series->record_size);
+  if (times)
+    ring_buf_series_spans(times, series->times.space, slot, count, capacity,
+                          sizeof(ring_buf_series_time_t));
+  return count == 0U ? 0 : records[1].size ? 2 : 1;
+}
+
+int ring_buf_series_range(struct ring_buf_series *series,
+                          ring_buf_series_time_t from,
+                          ring_buf_series_time_t to,
+                          struct ring_buf_span records[2],
+                          struct ring_buf_span times[2]) {
+  ring_buf_size_t index = ring_buf_series_find(series, from), count = 0U;
+  if (from < to)
+    count = ring_buf_series_find(series, to) - index;
+  return ring_buf_series_view(series, index, count, records, times);
+}
@@ -0,0 +1,129 @@
+/*!
+ * \file ring_buf_series.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf.h"
+
+/*!
+ * \defgroup ring_buf_series Time-Series Ring Buffer
+ * \ingroup ring_buf_series
+ * \brief Timestamped fixed-size records with lookup by time.
+ * \details A series keeps a history of records. It stores timestamps and
+ * records in two parallel ring buffers, a struct-of-arrays layout: one ring
+ * buffer of timestamps, another of equally-sized records, both holding the
+ * same number of entries. Putting into a full series drops the oldest entry.
+ *
+ * Timestamps come from a monotonic clock and never decrease. Searching
+ * therefore bisects the timestamps in logarithmic time, even across the point
+ * where the entries wrap around the end of their buffer space. Views answer
+ * the matching records, and optionally their timestamps, as one or two spans
+ * without copying.
+ * \{
+ */
+
+typedef uint64_t ring_buf_series_time_t;
+
+struct ring_buf_series {
+  struct ring_buf times, records;
+  ring_buf_size_t record_size;
+};
+
+/*!
+ * \brief Initialises an empty series.
+ * \param times Space for \c count timestamps.
+ * \param records Space for \c count records.
+ * \param count Capacity in entries.
+ * \param record_size Size of each record in bytes.
+ */
+void ring_buf_series_init(struct ring_buf_series *series,
+                          ring_buf_series_time_t *times, void *records,
+                          ring_buf_size_t count, ring_buf_size_t record_size);
+
+/*!
+ * \brief Number of entries in the series.
+ */
+static inline ring_buf_size_t
+ring_buf_series_count(const struct ring_buf_series *series) {
+  return ring_buf_used_space(&series->times) / sizeof(ring_buf_series_time_t);
+}
+
+/*!
+ * \brief Puts a timestamped record, dropping the oldest entry if full.
+ * \retval 0 on success.
+ * \retval -EINVAL if \c time precedes the latest timestamp.
+ */
+int ring_buf_series_put(struct ring_buf_series *series,
+                        ring_buf_series_time_t time, const void *record);
+
+/*!
+ * \brief Timestamp of an entry.
+ * \param index Index of the entry, oldest first, less than the count.
+ */
+ring_buf_series_time_t ring_buf_series_time(struct ring_buf_series *series,
+                                            ring_buf_size_t index);
+
+/*!
+ * \brief Finds the first entry at or after a time.
+ * \returns Index of the entry, oldest first, or the count of entries if all
+ * entries precede \c time.
+ */
+ring_buf_size_t ring_buf_series_find(struct ring_buf_series *series,
+                                     ring_buf_series_time_t time);
+
+/*!
+ * \brief Views a range of entries without copying.
+ * \param index Index of the first entry, oldest first.
+ * \param count Number of entries; clamped to the entries available.
+ * \param records Two spans of records.
+ * \param times Two spans of timestamps, or \c NULL.
+ * \returns Number of spans used: zero, one or two.
+ */
+int ring_buf_series_view(struct ring_buf_series *series, ring_buf_size_t index,
+                         ring_buf_size_t count, struct ring_buf_span records[2],
+                         struct ring_buf_span times[2]);
+
+/*!
+ * \brief Views all entries from time \c from up to but excluding time \c to.
+ * \returns Number of spans used: zero, one or two.
+ */
+int ring_buf_series_range(struct ring_buf_series *series,
+                          ring_buf_series_time_t from,
+                          ring_buf_series_time_t to,
+                          struct ring_buf_span records[2],
+                          struct ring_buf_span times[2]);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
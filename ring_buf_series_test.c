@@ -0,0 +1,56 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ring_buf_series.h"
+
+int ring_buf_series_test(int argc, char **argv) {
+  ring_buf_series_time_t times[8U];
+  float records[8U];
+  struct ring_buf_series series;
+  ring_buf_series_init(&series, times, records, 8U, sizeof(float));
+
+  struct ring_buf_span spans[2U], time_spans[2U];
+  assert(ring_buf_series_find(&series, 0U) == 0U);
+  assert(ring_buf_series_range(&series, 0U, 100U, spans, NULL) == 0);
+
+  /*
+   * Twelve entries overflow the eight-entry history. Only the last eight
+   * remain, timestamped 50 through 120, wrapping at the end of the spaces.
+   */
+  for (int i = 1; i <= 12; i++) {
+    float number = (float)i;
+    assert(ring_buf_series_put(&series, i * 10U, &number) == 0);
+  }
+  float number = 0.0F;
+  assert(ring_buf_series_put(&series, 119U, &number) == -EINVAL);
+  assert(ring_buf_series_count(&series) == 8U);
+  assert(ring_buf_series_time(&series, 0U) == 50U);
+  assert(ring_buf_series_time(&series, 7U) == 120U);
+
+  assert(ring_buf_series_find(&series, 0U) == 0U);
+  assert(ring_buf_series_find(&series, 55U) == 1U);
+  assert(ring_buf_series_find(&series, 60U) == 1U);
+  assert(ring_buf_series_find(&series, 120U) == 7U);
+  assert(ring_buf_series_find(&series, 121U) == 8U);
+
+  assert(ring_buf_series_range(&series, 60U, 110U, spans, time_spans) == 2);
+  assert(spans[0].space == records + 5 && spans[0].size == sizeof(float[3U]));
+  assert(spans[1].space == records && spans[1].size == sizeof(float[2U]));
+  assert(time_spans[0].space == times + 5);
+  assert(time_spans[1].size == sizeof(ring_buf_series_time_t[2U]));
+  float sum = 0.0F;
+  for (int i = 0; i < 2; i++)
+    for (ring_buf_size_t j = 0U; j < spans[i].size / sizeof(float); j++)
+      sum += ((float *)spans[i].space)[j];
+  assert(sum == 6.0F + 7.0F + 8.0F + 9.0F + 10.0F);
+
+  assert(ring_buf_series_range(&series, 90U, 121U, spans, NULL) == 1);
+  assert(spans[0].space == records && spans[0].size == sizeof(float[4U]));
+  assert(ring_buf_series_range(&series, 121U, 200U, spans, NULL) == 0);
+  assert(ring_buf_series_range(&series, 100U, 100U, spans, NULL) == 0);
+  assert(ring_buf_series_view(&series, 6U, 10U, spans, NULL) == 1);
+  assert(spans[0].size == sizeof(float[2U]));
+
+  return EXIT_SUCCESS;
+}
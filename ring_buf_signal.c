@@ -0,0 +1,87 @@
+/*!
+ * \file ring_buf_signal.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_signal.h"
+#include "ring_buf_wait.h"
+
+void ring_buf_signal_init(struct ring_buf_signal *ring,
+                          struct ring_buf *buf) {
+  ring->buf = buf;
+  ring->busy = ring->drops = 0;
+}
+
+/*
+ * Putting and draining go through views. The putter acquires the get zone's
+ * tail once and bounds its put by it; the drainer likewise acquires the put
+ * zone's tail and bounds its get by it. Releasing publishes the new tail
+ * after the copy.
+ */
+int ring_buf_signal_put_acquire(struct ring_buf_signal *ring,
+                                struct ring_buf *view, bool wait) {
+  while (ring_buf_atomic_exchange(&ring->busy, 1)) {
+    if (!wait) {
+      (void)ring_buf_atomic_fetch_add(&ring->drops, 1);
+      return -EBUSY;
+    }
+    ring_buf_wait_pause();
+  }
+  ring_buf_atomic_put_acquire(view, ring->buf);
+  return 0;
+}
+
+void ring_buf_signal_put_release(struct ring_buf_signal *ring,
+                                 const struct ring_buf *view) {
+  if (view)
+    ring_buf_atomic_put_release(ring->buf, view);
+  else
+    (void)ring_buf_atomic_fetch_add(&ring->drops, 1);
+  ring_buf_atomic_store(&ring->busy, 0);
+}
+
+int ring_buf_signal_put(struct ring_buf_signal *ring, const void *data,
+                        ring_buf_size_t size) {
+  struct ring_buf view;
+  int err = ring_buf_signal_put_acquire(ring, &view, false);
+  if (err < 0)
+    return err;
+  err = ring_buf_put_all(&view, data, size);
+  ring_buf_signal_put_release(ring, err < 0 ? NULL : &view);
+  return err;
+}
+
+ring_buf_size_t ring_buf_signal_drain(struct ring_buf_signal *ring,
+                                      void *data, ring_buf_size_t size) {
+  struct ring_buf *buf = ring->buf, view;
+  ring_buf_atomic_get_acquire(&view, buf);
+  ring_buf_size_t ack = ring_buf_get(&view, data, size);
+  (void)ring_buf_get_ack(&view, ack);
+  ring_buf_atomic_get_release(buf, &view);
+  return ack;
+}
+
+ring_buf_size_t ring_buf_signal_drops(struct ring_buf_signal *ring) {
+  return ring_buf_atomic_exchange(&ring->drops, 0);
+}
@@ -0,0 +1,114 @@
+/*!
+ * \file ring_buf_signal.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf_atomic.h"
+
+/*!
+ * \defgroup ring_buf_signal Signal-Safe Ring Buffer
+ * \ingroup ring_buf_signal
+ * \brief Async-signal-safe putting, for logging from signal handlers.
+ * \details Signal handlers cannot take locks or allocate memory, and a handler
+ * may interrupt a thread in the middle of its own put. A signal ring buffer
+ * guards its put zone with a lock-free busy flag. Putting tries to take the
+ * flag with one atomic exchange; on failure, because another handler or
+ * thread holds the put zone at that instant, it drops the data and counts the
+ * drop rather than waiting. Putting likewise drops data that does not fit.
+ * Ordinary threads sharing the ring buffer may instead acquire the put zone
+ * by waiting for the flag, so that contention between them loses nothing.
+ *
+ * Putting uses nothing but atomic operations and \c memcpy, which POSIX lists
+ * as async-signal-safe. It copies all or none and acknowledges its own put.
+ *
+ * One ordinary thread drains the ring buffer. Draining never interferes with
+ * putting: the putter only reads the get zone's tail, the drainer only reads
+ * the put zone's tail, and each publishes its own tail with release
+ * semantics.
+ * \{
+ */
+
+struct ring_buf_signal {
+  struct ring_buf *buf;
+  ring_buf_atomic_t busy, drops;
+};
+
+void ring_buf_signal_init(struct ring_buf_signal *ring, struct ring_buf *buf);
+
+/*!
+ * \brief Takes the put zone and acquires the producer's view of it.
+ * \details Put into the view, then release it whatever the outcome.
+ * \param wait Spins until the put zone comes free if \c true, serialising
+ * ordinary threads; tries once if \c false. Never wait from a signal handler,
+ * since the handler may have interrupted the thread that holds the put zone.
+ * \retval 0 on success.
+ * \retval -EBUSY if contended without waiting, counting a drop.
+ */
+int ring_buf_signal_put_acquire(struct ring_buf_signal *ring,
+                                struct ring_buf *view, bool wait);
+
+/*!
+ * \brief Publishes the view's acknowledged puts and frees the put zone.
+ * \param view Producer's view, or \c NULL to abandon the put and count a
+ * drop.
+ */
+void ring_buf_signal_put_release(struct ring_buf_signal *ring,
+                                 const struct ring_buf *view);
+
+/*!
+ * \brief Puts all or nothing, safely from a signal handler.
+ * \retval 0 on success.
+ * \retval -EBUSY if contended, dropping the data.
+ * \retval -EMSGSIZE if insufficient space, dropping the data.
+ */
+int ring_buf_signal_put(struct ring_buf_signal *ring, const void *data,
+                        ring_buf_size_t size);
+
+/*!
+ * \brief Drains up to \c size bytes.
+ * \details Call from one ordinary thread only.
+ * \param data Address of drained bytes, or \c NULL to discard.
+ * \returns Number of bytes drained.
+ */
+ring_buf_size_t ring_buf_signal_drain(struct ring_buf_signal *ring,
+                                      void *data, ring_buf_size_t size);
+
+/*!
+ * \brief Answers and resets the number of dropped puts.
+ */
+ring_buf_size_t ring_buf_signal_drops(struct ring_buf_signal *ring);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
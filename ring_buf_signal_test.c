@@ -0,0 +1,56 @@
+#include <assert.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ring_buf_signal.h"
+
+RING_BUF_DEFINE(buf, sizeof(int[8U]));
+
+static struct ring_buf_signal ring;
+
+static volatile sig_atomic_t sample;
+
+static void handler(int sig) {
+  int number = sample;
+  (void)ring_buf_signal_put(&ring, &number, sizeof(number));
+  (void)signal(sig, handler);
+}
+
+int ring_buf_signal_test(int argc, char **argv) {
+  ring_buf_signal_init(&ring, &buf);
+  (void)signal(SIGTERM, handler);
+
+  /*
+   * Capture samples faster than draining them. The ring buffer fills and
+   * drops the excess.
+   */
+  int sum = 0, number;
+  for (sample = 1; sample <= 10; sample++) {
+    assert(raise(SIGTERM) == 0);
+    if (sample % 2 == 0)
+      while (ring_buf_signal_drain(&ring, &number, sizeof(number)))
+        sum += number;
+  }
+  assert(sum == 1 + 2 + 3 + 4 + 5 + 6 + 7 + 8 + 9 + 10);
+  assert(ring_buf_signal_drops(&ring) == 0U);
+
+  for (sample = 1; sample <= 10; sample++)
+    assert(raise(SIGTERM) == 0);
+  assert(ring_buf_used_space(&buf) == sizeof(int[8U]));
+  assert(ring_buf_signal_drops(&ring) == 2U);
+
+  /*
+   * Interrupting a put in progress drops the interrupting sample.
+   */
+  (void)ring_buf_signal_drain(&ring, NULL, sizeof(int[8U]));
+  ring.busy = 1;
+  assert(raise(SIGTERM) == 0);
+  ring.busy = 0;
+  assert(ring_buf_is_empty(&buf));
+  assert(ring_buf_signal_drops(&ring) == 1U);
+  assert(ring_buf_signal_drops(&ring) == 0U);
+
+  (void)signal(SIGTERM, SIG_DFL);
+  return EXIT_SUCCESS;
+}
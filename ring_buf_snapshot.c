@@ -0,0 +1,53 @@
+/*!
+ * \file ring_buf_snapshot.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_snapshot.h"
+
+int ring_buf_snapshot(const struct ring_buf *buf,
+                      struct ring_buf_snapshot *snapshot,
+                      struct ring_buf_span spans[2]) {
+  ring_buf_size_t offset = ring_buf_offset(buf, buf->get.tail);
+  ring_buf_size_t size = buf->put.tail - buf->get.tail;
+  ring_buf_size_t first = buf->size - offset;
+  if (first > size)
+    first = size;
+  snapshot->tail = buf->get.tail;
+  snapshot->size = size;
+  spans[0].space = (uint8_t *)buf->space + offset;
+  spans[0].size = first;
+  spans[1].space = buf->space;
+  spans[1].size = size - first;
+  return size == 0U ? 0 : spans[1].size ? 2 : 1;
+}
+
+int ring_buf_restore(struct ring_buf *buf,
+                     const struct ring_buf_snapshot *snapshot,
+                     const void *data) {
+  if (snapshot->size > buf->size)
+    return -EMSGSIZE;
+  ring_buf_reset(buf, snapshot->tail);
+  return ring_buf_put_all(buf, data, (ring_buf_size_t)snapshot->size);
+}
@@ -0,0 +1,100 @@
+/*!
+ * \file ring_buf_snapshot.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf.h"
+
+/*!
+ * \defgroup ring_buf_snapshot Ring Buffer Snapshots
+ * \ingroup ring_buf_snapshot
+ * \brief Checkpoints ring buffers in proportion to their occupancy.
+ * \details A snapshot comprises fixed-width metadata plus the ring buffer's
+ * acknowledged contents, one or two spans of buffer space that a checkpoint
+ * can write without copying. The spans correspond directly to a POSIX \c
+ * iovec array:
+ *
+ * \code
+ * struct ring_buf_snapshot snapshot;
+ * struct ring_buf_span spans[2];
+ * int count = ring_buf_snapshot(&buf, &snapshot, spans);
+ * struct iovec iov[3] = {{&snapshot, sizeof(snapshot)}};
+ * for (int i = 0; i < count; i++)
+ *   iov[1 + i] = (struct iovec){spans[i].space, spans[i].size};
+ * (void)writev(fd, iov, 1 + count);
+ * \endcode
+ *
+ * Restoring rebuilds a ring buffer from the metadata and the contents, into
+ * any buffer space large enough for the contents. The restored ring buffer
+ * resumes at the same stream position.
+ *
+ * Snapshots exclude claimed but unacknowledged space. Unacknowledged gets
+ * remain in the snapshot; unacknowledged puts do not.
+ * \{
+ */
+
+struct ring_buf_snapshot {
+  /*!
+   * \brief Stream position of the oldest byte, the get zone's tail.
+   */
+  uint64_t tail;
+  /*!
+   * \brief Number of bytes in the snapshot.
+   */
+  uint64_t size;
+};
+
+/*!
+ * \brief Takes a snapshot of a ring buffer.
+ * \param spans Two spans of contents.
+ * \returns Number of spans used: zero, one or two.
+ */
+int ring_buf_snapshot(const struct ring_buf *buf,
+                      struct ring_buf_snapshot *snapshot,
+                      struct ring_buf_span spans[2]);
+
+/*!
+ * \brief Restores a ring buffer from a snapshot.
+ * \details Resets the ring buffer, discarding its previous contents.
+ * \param data Address of the snapshot's contents, contiguous.
+ * \retval 0 on success.
+ * \retval -EMSGSIZE if the contents exceed the buffer space.
+ */
+int ring_buf_restore(struct ring_buf *buf,
+                     const struct ring_buf_snapshot *snapshot,
+                     const void *data);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,54 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_buf_snapshot.h"
+
+int ring_buf_snapshot_test(int argc, char **argv) {
+  RING_BUF_DEFINE(buf, 16U);
+  struct ring_buf_snapshot snapshot;
+  struct ring_buf_span spans[2U];
+  assert(ring_buf_snapshot(&buf, &snapshot, spans) == 0);
+
+  /*
+   * Twelve bytes wrap around the end of the sixteen-byte space.
+   */
+  assert(ring_buf_put_all(&buf, "abcdefghijkl", 12U) == 0);
+  assert(ring_buf_get_all(&buf, NULL, 8U) == 0);
+  assert(ring_buf_put_all(&buf, "mnopqrst", 8U) == 0);
+  assert(ring_buf_snapshot(&buf, &snapshot, spans) == 2);
+  assert(snapshot.tail == 8U && snapshot.size == 12U);
+  assert(spans[0].size == 8U && memcmp(spans[0].space, "ijklmnop", 8U) == 0);
+  assert(spans[1].size == 4U && memcmp(spans[1].space, "qrst", 4U) == 0);
+
+  char data[12U];
+  (void)memcpy(data, spans[0].space, spans[0].size);
+  (void)memcpy(data + spans[0].size, spans[1].space, spans[1].size);
+
+  /*
+   * Restore into larger and smaller spaces.
+   */
+  {
+    RING_BUF_DEFINE(large, 32U);
+    assert(ring_buf_restore(&large, &snapshot, data) == 0);
+    assert(large.get.tail == buf.get.tail && large.put.tail == buf.put.tail);
+    assert(ring_buf_snapshot(&large, &snapshot, spans) == 1);
+    assert(memcmp(spans[0].space, "ijklmnopqrst", 12U) == 0);
+    assert(ring_buf_put_all(&large, "uvwxyz", 6U) == 0);
+  }
+  {
+    RING_BUF_DEFINE(small, 12U);
+    assert(ring_buf_restore(&small, &snapshot, data) == 0);
+    assert(ring_buf_is_full(&small));
+    char got[12U];
+    assert(ring_buf_get_all(&small, got, sizeof(got)) == 0);
+    assert(memcmp(got, "ijklmnopqrst", sizeof(got)) == 0);
+  }
+  {
+    RING_BUF_DEFINE(tiny, 8U);
+    assert(ring_buf_restore(&tiny, &snapshot, data) == -EMSGSIZE);
+  }
+
+  return EXIT_SUCCESS;
+}
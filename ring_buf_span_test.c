@@ -0,0 +1,57 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_buf.h"
+
+struct header {
+  uint16_t type, length;
+};
+
+int ring_buf_span_test(int argc, char **argv) {
+  RING_BUF_DEFINE(buf, 16U);
+  struct header header = {1U, 5U};
+  char payload[] = "hello", trailer = '!';
+  const struct ring_buf_span message[] = {
+      {&header, sizeof(header)}, {payload, 5U}, {NULL, 0U}, {&trailer, 1U}};
+
+  /*
+   * Ten bytes per message. The second message wraps around the end of the
+   * buffer space; the third does not fit at all.
+   */
+  assert(ring_buf_putv_all(&buf, message, 4U) == 0);
+  assert(ring_buf_used_space(&buf) == 10U);
+  assert(ring_buf_putv_all(&buf, message, 4U) == -EMSGSIZE);
+  assert(ring_buf_used_space(&buf) == 10U);
+
+  struct header got_header;
+  char got_payload[5U], got_trailer;
+  const struct ring_buf_span got[] = {{&got_header, sizeof(got_header)},
+                                      {got_payload, sizeof(got_payload)},
+                                      {&got_trailer, 1U}};
+  assert(ring_buf_getv_all(&buf, got, 3U) == 0);
+  assert(got_header.type == 1U && got_header.length == 5U);
+  assert(memcmp(got_payload, "hello", 5U) == 0 && got_trailer == '!');
+
+  assert(ring_buf_putv_all(&buf, message, 4U) == 0);
+  (void)memset(got_payload, 0, sizeof(got_payload));
+  const struct ring_buf_span skip[] = {{NULL, sizeof(got_header)},
+                                       {got_payload, sizeof(got_payload)}};
+  assert(ring_buf_getv_all(&buf, skip, 2U) == 0);
+  assert(memcmp(got_payload, "hello", 5U) == 0);
+  assert(ring_buf_getv_all(&buf, got, 3U) == -EAGAIN);
+  assert(ring_buf_used_space(&buf) == 1U);
+
+  /*
+   * Partial gathering answers the bytes buffered, unacknowledged.
+   */
+  assert(ring_buf_putv(&buf, message, 4U) == 10U);
+  assert(ring_buf_putv(&buf, message, 4U) == 5U);
+  assert(ring_buf_put_ack(&buf, 15U) == 0);
+  assert(ring_buf_getv(&buf, got, 3U) == 10U);
+  assert(ring_buf_get_ack(&buf, 10U) == 0);
+  assert(ring_buf_used_space(&buf) == 6U);
+
+  return EXIT_SUCCESS;
+}
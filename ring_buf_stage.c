@@ -0,0 +1,138 @@
+/*!
+ * \file ring_buf_stage.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_stage.h"
+
+#include <string.h>
+
+void ring_buf_stage_init(struct ring_buf_stage *stage,
+                         ring_buf_stage_function_t function, void *context,
+                         ring_buf_size_t batch) {
+  stage->in = stage->out = NULL;
+  stage->batch = batch;
+  stage->function = function;
+  stage->context = context;
+  stage->closed = NULL;
+  stage->done = 0;
+  stage->closing = false;
+  (void)memset(&stage->counters, 0, sizeof(stage->counters));
+}
+
+void ring_buf_stage_connect(struct ring_buf_stage *upstream,
+                            struct ring_buf_stage *downstream,
+                            struct ring_buf *buf) {
+  upstream->out = buf;
+  downstream->in = buf;
+  downstream->closed = &upstream->done;
+}
+
+void ring_buf_stage_close(struct ring_buf_stage *stage) {
+  stage->closing = true;
+}
+
+/*!
+ * \brief Answers true if upstream has closed and the input has run dry.
+ * \details Upstream publishes its last output before closing. Seeing the
+ * close therefore guarantees that acquiring the input's put tail afterwards
+ * sees all the input.
+ */
+static bool ring_buf_stage_drained(const struct ring_buf_stage *stage) {
+  if (stage->closed == NULL || !ring_buf_atomic_load(stage->closed))
+    return false;
+  return ring_buf_atomic_index_load(&stage->in->put.tail) ==
+         stage->in->get.tail;
+}
+
+/*
+ * The step works on views of its input and output. Acquiring the views loads
+ * the other sides' tails once; the claim and the function's puts read only
+ * the views. The function sees the output view as the stage's output.
+ * Releasing the views stores this side's tails, publishing all the output at
+ * once and acknowledging the consumed input, which also rewinds the
+ * unconsumed remainder of the claim. A pending close takes effect only after
+ * the release.
+ */
+int ring_buf_stage_step(struct ring_buf_stage *stage) {
+  struct ring_buf *in = stage->in, *out = stage->out, input, output;
+  struct ring_buf_stage_counters *counters = &stage->counters;
+  if (ring_buf_atomic_load(&stage->done))
+    return -EPIPE;
+  if (stage->closing) {
+    ring_buf_atomic_store(&stage->done, 1);
+    return -EPIPE;
+  }
+  counters->steps++;
+  void *data = NULL;
+  ring_buf_size_t size = stage->batch;
+  if (in) {
+    ring_buf_atomic_get_acquire(&input, in);
+    counters->occupancy += ring_buf_used_space(&input);
+    if ((size = ring_buf_get_claim(&input, &data, size)) == 0U) {
+      if (ring_buf_stage_drained(stage)) {
+        ring_buf_atomic_store(&stage->done, 1);
+        return -EPIPE;
+      }
+      counters->idle++;
+      return -EAGAIN;
+    }
+  }
+  if (out) {
+    ring_buf_atomic_put_acquire(&output, out);
+    stage->out = &output;
+  }
+  ring_buf_size_t consumed = stage->function(stage, data, size);
+  if (out) {
+    stage->out = out;
+    if (output.put.head != out->put.tail) {
+      counters->bytes_out += output.put.head - out->put.tail;
+      output.put.tail = output.put.head;
+      ring_buf_atomic_put_release(out, &output);
+    }
+  }
+  if (in && consumed) {
+    input.get.head = input.get.tail += consumed;
+    ring_buf_atomic_get_release(in, &input);
+    counters->bytes_in += consumed;
+  }
+  if (stage->closing)
+    ring_buf_atomic_store(&stage->done, 1);
+  if (consumed == 0U) {
+    counters->blocked++;
+    return -EBUSY;
+  }
+  return (int)consumed;
+}
+
+void ring_buf_stage_run(struct ring_buf_stage *stage,
+                        struct ring_buf_wait *wait) {
+  unsigned polls = 0U;
+  int step;
+  while ((step = ring_buf_stage_step(stage)) != -EPIPE)
+    if (step < 0)
+      ring_buf_wait_idle(wait, polls++);
+    else
+      polls = 0U;
+}
@@ -0,0 +1,155 @@
+/*!
+ * \file ring_buf_stage.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf_atomic.h"
+#include "ring_buf_wait.h"
+
+/*!
+ * \defgroup ring_buf_stage Ring Buffer Pipeline Stages
+ * \ingroup ring_buf_stage
+ * \brief Streaming pipelines of stages joined by single-producer,
+ * single-consumer ring buffers.
+ * \details A stage wraps a function. Each step claims a batch of contiguous
+ * input and passes it to the function, which puts its output into the
+ * stage's output ring buffer and answers how many input bytes it consumed.
+ * The function puts or claims output space but does not acknowledge it. The
+ * step then publishes all the output at once and acknowledges the consumed
+ * input, releasing the rest of the claim for the next step.
+ *
+ * Backpressure needs no extra machinery. A function that finds its output
+ * full consumes nothing; its stage stops acknowledging input, its input fills
+ * and the stage upstream stalls in turn.
+ *
+ * A source stage has no input: its function produces into the output and
+ * closes the stage when the stream ends. A sink stage has no output. Closing
+ * flows downstream: a stage whose upstream has closed closes itself once its
+ * input runs dry.
+ *
+ * Stages stay operating system agnostic. Create one thread per stage, pin it
+ * using the platform's affinity call, then run the stage on that thread; the
+ * stages share nothing but their ring buffers and closing flags. The
+ * counters belong to the stage's thread. Others may read them for
+ * monitoring, approximately.
+ * \{
+ */
+
+struct ring_buf_stage;
+
+/*!
+ * \brief Stage function.
+ * \param data Claimed input, or \c NULL for a source stage.
+ * \param size Number of claimed input bytes, or the batch size for a source
+ * stage.
+ * \returns Number of input bytes consumed, at most \c size. Zero signals
+ * backpressure: the function could not make progress.
+ */
+typedef ring_buf_size_t (*ring_buf_stage_function_t)(
+    struct ring_buf_stage *stage, const void *data, ring_buf_size_t size);
+
+/*!
+ * \brief Per-stage counters.
+ * \details Dividing the occupancy by the number of steps gives the input's
+ * average used space.
+ */
+struct ring_buf_stage_counters {
+  uint64_t steps, idle, blocked;
+  uint64_t bytes_in, bytes_out, occupancy;
+};
+
+struct ring_buf_stage {
+  struct ring_buf *in, *out;
+  ring_buf_size_t batch;
+  ring_buf_stage_function_t function;
+  void *context;
+  /*!
+   * \brief Upstream's closing flag, or \c NULL if none.
+   */
+  const ring_buf_atomic_t *closed;
+  ring_buf_atomic_t done;
+  /*!
+   * \brief Close pending until the current step publishes its output.
+   */
+  bool closing;
+  struct ring_buf_stage_counters counters;
+};
+
+/*!
+ * \brief Initialises an unconnected stage.
+ * \param batch Maximum number of input bytes per step.
+ */
+void ring_buf_stage_init(struct ring_buf_stage *stage,
+                         ring_buf_stage_function_t function, void *context,
+                         ring_buf_size_t batch);
+
+/*!
+ * \brief Connects two stages by a ring buffer.
+ */
+void ring_buf_stage_connect(struct ring_buf_stage *upstream,
+                            struct ring_buf_stage *downstream,
+                            struct ring_buf *buf);
+
+/*!
+ * \brief Closes a stage's output.
+ * \details Source stage functions call this at the end of their stream. The
+ * close takes effect once the step publishes the function's output, so that
+ * downstream sees the last output before it sees the close.
+ */
+void ring_buf_stage_close(struct ring_buf_stage *stage);
+
+/*!
+ * \brief Runs one step.
+ * \details During the function, the stage's output points at a private view
+ * of the output ring buffer, whose free space reflects the downstream tail
+ * acquired at the start of the step.
+ * \returns Number of input bytes consumed, or negative error.
+ * \retval -EAGAIN if the input is empty.
+ * \retval -EBUSY if the function made no progress.
+ * \retval -EPIPE if the stage has closed.
+ */
+int ring_buf_stage_step(struct ring_buf_stage *stage);
+
+/*!
+ * \brief Runs a stage until it closes.
+ * \details Steps repeatedly, relaxing according to the wait strategy while
+ * the stage makes no progress. Parking hooks must also return when upstream
+ * closes.
+ */
+void ring_buf_stage_run(struct ring_buf_stage *stage,
+                        struct ring_buf_wait *wait);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
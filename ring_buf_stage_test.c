@@ -0,0 +1,138 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "ring_buf_stage.h"
+
+/*
+ * Source: puts the numbers 1 to 100 as whole 32-bit records.
+ */
+static ring_buf_size_t source(struct ring_buf_stage *stage, const void *data,
+                              ring_buf_size_t size) {
+  int32_t *next = stage->context;
+  ring_buf_size_t count = 0U;
+  (void)data;
+  while (*next <= 100 && count < size / sizeof(*next) &&
+         ring_buf_free_space(stage->out) >= sizeof(*next)) {
+    (void)ring_buf_put(stage->out, next, sizeof(*next));
+    ++*next;
+    count++;
+  }
+  if (*next > 100)
+    ring_buf_stage_close(stage);
+  return count * sizeof(*next);
+}
+
+/*
+ * Doubles each whole record for which the output has room.
+ */
+static ring_buf_size_t doubler(struct ring_buf_stage *stage, const void *data,
+                               ring_buf_size_t size) {
+  const int32_t *numbers = data;
+  ring_buf_size_t count = 0U;
+  for (; count < size / sizeof(*numbers); count++) {
+    int32_t number = 2 * numbers[count];
+    if (ring_buf_free_space(stage->out) < sizeof(number))
+      break;
+    (void)ring_buf_put(stage->out, &number, sizeof(number));
+  }
+  return count * sizeof(*numbers);
+}
+
+/*
+ * Sums one record at most per step, so as to run slower than upstream.
+ */
+static ring_buf_size_t sink(struct ring_buf_stage *stage, const void *data,
+                            ring_buf_size_t size) {
+  int32_t *sum = stage->context;
+  if (size < sizeof(*sum))
+    return 0U;
+  *sum += *(const int32_t *)data;
+  return sizeof(*sum);
+}
+
+/*
+ * Source that puts one record and closes, then steps downstream from within
+ * its own step, at the moment a downstream thread might look.
+ */
+static ring_buf_size_t source_closing(struct ring_buf_stage *stage,
+                                      const void *data, ring_buf_size_t size) {
+  struct ring_buf_stage *downstream = stage->context;
+  int32_t number = 1;
+  (void)data;
+  (void)size;
+  (void)ring_buf_put(stage->out, &number, sizeof(number));
+  ring_buf_stage_close(stage);
+  assert(ring_buf_stage_step(downstream) == -EAGAIN);
+  return sizeof(number);
+}
+
+int ring_buf_stage_test(int argc, char **argv) {
+  RING_BUF_DEFINE(first, sizeof(int32_t[4U]));
+  RING_BUF_DEFINE(second, sizeof(int32_t[4U]));
+  int32_t next = 1, sum = 0;
+  struct ring_buf_stage stages[3U];
+  ring_buf_stage_init(&stages[0], source, &next, sizeof(int32_t[3U]));
+  ring_buf_stage_init(&stages[1], doubler, NULL, sizeof(int32_t[8U]));
+  ring_buf_stage_init(&stages[2], sink, &sum, sizeof(int32_t[8U]));
+  ring_buf_stage_connect(&stages[0], &stages[1], &first);
+  ring_buf_stage_connect(&stages[1], &stages[2], &second);
+
+  /*
+   * Nothing downstream consumes yet. The source fills its output then feels
+   * the backpressure.
+   */
+  assert(ring_buf_stage_step(&stages[2]) == -EAGAIN);
+  assert(ring_buf_stage_step(&stages[0]) == sizeof(int32_t[3U]));
+  assert(ring_buf_stage_step(&stages[0]) == sizeof(int32_t));
+  assert(ring_buf_stage_step(&stages[0]) == -EBUSY);
+
+  /*
+   * Step the stages in turn as if on separate threads. Stages close in order
+   * from source to sink.
+   */
+  unsigned closed = 0U;
+  while (closed < 3U) {
+    closed = 0U;
+    for (int i = 0; i < 3; i++)
+      if (ring_buf_stage_step(&stages[i]) == -EPIPE)
+        closed++;
+  }
+  assert(sum == 100 * 101);
+  assert(ring_buf_is_empty(&first) && ring_buf_is_empty(&second));
+
+  const struct ring_buf_stage_counters *counters = &stages[1].counters;
+  assert(counters->bytes_in == sizeof(int32_t[100U]));
+  assert(counters->bytes_out == sizeof(int32_t[100U]));
+  assert(stages[0].counters.blocked >= 1U);
+  assert(stages[0].counters.bytes_out == sizeof(int32_t[100U]));
+  assert(stages[2].counters.bytes_in == sizeof(int32_t[100U]));
+  assert(stages[2].counters.occupancy >= stages[2].counters.steps);
+
+  /*
+   * Running a closed stage returns at once.
+   */
+  struct ring_buf_wait wait;
+  ring_buf_wait_init(&wait, RING_BUF_WAIT_SPIN, RING_BUF_WAIT_SPINS);
+  ring_buf_stage_run(&stages[1], &wait);
+
+  /*
+   * Closing defers until the step publishes the last output. Downstream
+   * neither sees the close early nor drops the last record.
+   */
+  {
+    RING_BUF_DEFINE(buf, sizeof(int32_t[4U]));
+    sum = 0;
+    ring_buf_stage_init(&stages[0], source_closing, &stages[1],
+                        sizeof(int32_t));
+    ring_buf_stage_init(&stages[1], sink, &sum, sizeof(int32_t));
+    ring_buf_stage_connect(&stages[0], &stages[1], &buf);
+    assert(ring_buf_stage_step(&stages[0]) == sizeof(int32_t));
+    assert(ring_buf_stage_step(&stages[0]) == -EPIPE);
+    assert(ring_buf_stage_step(&stages[1]) == sizeof(int32_t));
+    assert(ring_buf_stage_step(&stages[1]) == -EPIPE);
+    assert(sum == 1);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ring_buf_stage.h"
+
+#define RECORDS 100000U
+
+/*
+ * Source: puts the numbers 0 to RECORDS - 1 as whole 32-bit records, then
+ * closes at once, within the same step as its last output.
+ */
+static ring_buf_size_t source(struct ring_buf_stage *stage, const void *data,
+                              ring_buf_size_t size) {
+  uint32_t *next = stage->context;
+  ring_buf_size_t count = 0U;
+  (void)data;
+  while (*next < RECORDS && count < size / sizeof(*next) &&
+         ring_buf_free_space(stage->out) >= sizeof(*next)) {
+    (void)ring_buf_put(stage->out, next, sizeof(*next));
+    ++*next;
+    count++;
+  }
+  if (*next == RECORDS)
+    ring_buf_stage_close(stage);
+  return count * sizeof(*next);
+}
+
+/*
+ * Copies whole records for which the output has room.
+ */
+static ring_buf_size_t copier(struct ring_buf_stage *stage, const void *data,
+                              ring_buf_size_t size) {
+  ring_buf_size_t count = size / sizeof(uint32_t);
+  ring_buf_size_t room = ring_buf_free_space(stage->out) / sizeof(uint32_t);
+  if (count > room)
+    count = room;
+  (void)ring_buf_put(stage->out, data, count * sizeof(uint32_t));
+  return count * sizeof(uint32_t);
+}
+
+/*
+ * Checks that the records arrive in order, none missing.
+ */
+static ring_buf_size_t sink(struct ring_buf_stage *stage, const void *data,
+                            ring_buf_size_t size) {
+  uint32_t *expect = stage->context;
+  ring_buf_size_t count = size / sizeof(*expect);
+  for (ring_buf_size_t index = 0U; index < count; index++) {
+    uint32_t record;
+    (void)memcpy(&record, (const uint8_t *)data + index * sizeof(record),
+                 sizeof(record));
+    assert(record == *expect);
+    ++*expect;
+  }
+  return count * sizeof(*expect);
+}
+
+static void yield(void *context) {
+  (void)context;
+  (void)sched_yield();
+}
+
+static void *run(void *arg) {
+  struct ring_buf_wait wait;
+  ring_buf_wait_init(&wait, RING_BUF_WAIT_YIELD, 100U);
+  wait.yield = yield;
+  ring_buf_stage_run(arg, &wait);
+  return NULL;
+}
+
+/*
+ * Runs a source, two copiers and a sink, one thread each. Small rings keep
+ * the stages handing over constantly. Every record must reach the sink
+ * after the source closes, in order.
+ */
+int ring_buf_stage_thread_test(int argc, char **argv) {
+  RING_BUF_DEFINE(first, sizeof(uint32_t[16U]));
+  RING_BUF_DEFINE(second, sizeof(uint32_t[8U]));
+  RING_BUF_DEFINE(third, sizeof(uint32_t[4U]));
+  uint32_t next = 0U, expect = 0U;
+  struct ring_buf_stage stages[4U];
+  ring_buf_stage_init(&stages[0], source, &next, sizeof(uint32_t[5U]));
+  ring_buf_stage_init(&stages[1], copier, NULL, sizeof(uint32_t[16U]));
+  ring_buf_stage_init(&stages[2], copier, NULL, sizeof(uint32_t[16U]));
+  ring_buf_stage_init(&stages[3], sink, &expect, sizeof(uint32_t[3U]));
+  ring_buf_stage_connect(&stages[0], &stages[1], &first);
+  ring_buf_stage_connect(&stages[1], &stages[2], &second);
+  ring_buf_stage_connect(&stages[2], &stages[3], &third);
+
+  pthread_t threads[4U];
+  for (int i = 0; i < 4; i++)
+    assert(pthread_create(&threads[i], NULL, run, &stages[i]) == 0);
+  for (int i = 0; i < 4; i++)
+    assert(pthread_join(threads[i], NULL) == 0);
+
+  assert(next == RECORDS && expect == RECORDS);
+  for (int i = 1; i < 4; i++)
+    assert(stages[i].counters.bytes_in == sizeof(uint32_t) * RECORDS);
+  assert(ring_buf_is_empty(&first) && ring_buf_is_empty(&second) &&
+         ring_buf_is_empty(&third));
+  return EXIT_SUCCESS;
+}
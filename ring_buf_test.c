@@ -7,5 +7,34 @@
 int ring_buf_test(int argc, char **argv) {
   int rc = EXIT_SUCCESS;
 
+  /*
+   * Tails count bytes ever put and got, whatever the buffer size.
+   */
+  {
+    RING_BUF_DEFINE(buf, 7U);
+    ring_buf_reset(&buf, 0U);
+    unsigned char bytes[5U] = {0U}, got[5U];
+    for (int i = 0; i < 100; i++) {
+      assert(ring_buf_put_all(&buf, bytes, sizeof(bytes)) == 0);
+      assert(ring_buf_get_all(&buf, got, sizeof(got)) == 0);
+    }
+    assert(buf.put.tail == 500U && buf.get.tail == 500U);
+  }
+
+  /*
+   * Power-of-two sizes cross the index wrap-around seamlessly.
+   */
+  {
+    RING_BUF_DEFINE(buf, 8U);
+    ring_buf_reset(&buf, UINT64_MAX - 2U);
+    unsigned char bytes[6U] = {1U, 2U, 3U, 4U, 5U, 6U}, got[6U];
+    assert(ring_buf_put_all(&buf, bytes, sizeof(bytes)) == 0);
+    assert(ring_buf_used_space(&buf) == 6U && buf.put.tail == 3U);
+    assert(ring_buf_get_all(&buf, got, sizeof(got)) == 0);
+    for (int i = 0; i < 6; i++)
+      assert(got[i] == bytes[i]);
+    assert(ring_buf_is_empty(&buf));
+  }
+
   return rc;
 }
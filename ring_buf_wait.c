@@ -0,0 +1,137 @@
+/*!
+ * \file ring_buf_wait.c
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buf_wait.h"
+#include "ring_buf_atomic.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+void ring_buf_wait_init(struct ring_buf_wait *wait,
+                        enum ring_buf_wait_kind kind, unsigned spins) {
+  wait->kind = kind;
+  wait->spins = spins;
+  wait->average = 0U;
+  wait->yield = NULL;
+  wait->park = NULL;
+  wait->context = NULL;
+}
+
+void ring_buf_wait_pause(void) {
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+  __asm__ __volatile__("pause" ::: "memory");
+#elif defined(__GNUC__) && (defined(__aarch64__) || defined(__arm__))
+  __asm__ __volatile__("yield" ::: "memory");
+#elif defined(__GNUC__)
+  __asm__ __volatile__("" ::: "memory");
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+  _mm_pause();
+  _ReadWriteBarrier();
+#elif defined(_MSC_VER)
+  __yield();
+  _ReadWriteBarrier();
+#endif
+}
+
+/*!
+ * \brief Spin budget for the next wait.
+ * \details The adaptive strategy spins for twice its average if the average
+ * fits within the budget. Otherwise waits typically outlast any sensible spin
+ * and the strategy parks almost at once.
+ */
+static unsigned ring_buf_wait_budget(const struct ring_buf_wait *wait) {
+  unsigned average;
+  switch (wait->kind) {
+  case RING_BUF_WAIT_ADAPTIVE:
+    average = wait->average >> 4U;
+    return average < wait->spins / 2U ? 2U * average + 1U : wait->spins / 16U;
+  default:
+    return wait->spins;
+  }
+}
+
+/*!
+ * \brief Learns from one completed wait.
+ * \details Exponential moving average with a weight of one eighth. Parking
+ * counts as a full budget's worth of polls.
+ */
+static void ring_buf_wait_learn(struct ring_buf_wait *wait, unsigned polls) {
+  if (wait->kind != RING_BUF_WAIT_ADAPTIVE)
+    return;
+  if (polls > wait->spins)
+    polls = wait->spins;
+  int delta = (int)(polls << 4U) - (int)wait->average;
+  wait->average += delta / 8;
+}
+
+static void ring_buf_wait_relax(struct ring_buf_wait *wait, unsigned polls,
+                                unsigned budget) {
+  void (*relax)(void *context);
+  if (wait->kind == RING_BUF_WAIT_SPIN || polls < budget)
+    relax = NULL;
+  else if (wait->kind == RING_BUF_WAIT_YIELD)
+    relax = wait->yield;
+  else
+    relax = wait->park;
+  if (relax)
+    relax(wait->context);
+  else
+    ring_buf_wait_pause();
+}
+
+void ring_buf_wait_idle(struct ring_buf_wait *wait, unsigned polls) {
+  ring_buf_wait_relax(wait, polls, ring_buf_wait_budget(wait));
+}
+
+/*
+ * Polling acquires the other side's tail and measures from the caller's own
+ * head, which only the caller writes. Seeing enough data acquires the data;
+ * seeing enough space acquires the other side's last reads of it.
+ */
+int ring_buf_wait_get(const struct ring_buf *buf, struct ring_buf_wait *wait,
+                      ring_buf_size_t size) {
+  if (size > buf->size)
+    return -EMSGSIZE;
+  unsigned polls = 0U, budget = ring_buf_wait_budget(wait);
+  while (ring_buf_atomic_index_load(&buf->put.tail) - buf->get.head < size)
+    ring_buf_wait_relax(wait, polls++, budget);
+  ring_buf_wait_learn(wait, polls > budget ? wait->spins : polls);
+  return 0;
+}
+
+int ring_buf_wait_put(const struct ring_buf *buf, struct ring_buf_wait *wait,
+                      ring_buf_size_t size) {
+  if (size > buf->size)
+    return -EMSGSIZE;
+  unsigned polls = 0U, budget = ring_buf_wait_budget(wait);
+  while (buf->size - (buf->put.head -
+                      ring_buf_atomic_index_load(&buf->get.tail)) <
+         size)
+    ring_buf_wait_relax(wait, polls++, budget);
+  ring_buf_wait_learn(wait, polls > budget ? wait->spins : polls);
+  return 0;
+}
@@ -0,0 +1,133 @@
+/*!
+ * \file ring_buf_wait.h
+ * \copyright Roy Ratcliffe, Northumberland, United Kingdom
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,  to any person obtaining a
+ * copy  of  this  software  and    associated   documentation  files  (the
+ * "Software"), to deal in  the   Software  without  restriction, including
+ * without limitation the rights to  use,   copy,  modify,  merge, publish,
+ * distribute, sublicense, and/or sell  copies  of   the  Software,  and to
+ * permit persons to whom the Software is   furnished  to do so, subject to
+ * the following conditions:
+ *
+ *     The above copyright notice and this permission notice shall be
+ *     included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT  WARRANTY OF ANY KIND, EXPRESS
+ * OR  IMPLIED,  INCLUDING  BUT  NOT   LIMITED    TO   THE   WARRANTIES  OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR   PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS  OR   COPYRIGHT  HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY,  WHETHER   IN  AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM,  OUT  OF   OR  IN  CONNECTION  WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ring_buf.h"
+
+/*!
+ * \defgroup ring_buf_wait Ring Buffer Waiting
+ * \ingroup ring_buf_wait
+ * \brief Selectable strategies for blocking puts and gets.
+ * \details Blocking waits poll the ring buffer until it holds enough data to
+ * get or enough space to put. What happens between polls depends on the
+ * strategy:
+ *
+ * - spin: busy polls with a processor pause hint between polls, never
+ *   surrendering the processor;
+ * - yield: spins up to a budget of polls, then yields between polls;
+ * - park: spins up to a budget, then parks between polls;
+ * - adaptive: parks like the previous strategy but learns its own spin budget
+ *   from a moving average of how many polls recent waits needed.
+ *
+ * Polling acquires the other side's tail, so waiting works across threads:
+ * once the wait returns, the awaited bytes or space are visible to the
+ * caller.
+ *
+ * Yielding and parking go through hooks, keeping the strategies operating
+ * system agnostic: \c sched_yield or \c SwitchToThread for yielding; a futex,
+ * a selector wait or an RTOS semaphore for parking. Parking must return once
+ * the other side acknowledges, and may return spuriously. Missing hooks fall
+ * back to pausing.
+ * \{
+ */
+
+enum ring_buf_wait_kind {
+  RING_BUF_WAIT_SPIN,
+  RING_BUF_WAIT_YIELD,
+  RING_BUF_WAIT_PARK,
+  RING_BUF_WAIT_ADAPTIVE,
+};
+
+/*!
+ * \brief Default spin budget in polls.
+ */
+#define RING_BUF_WAIT_SPINS 1000U
+
+struct ring_buf_wait {
+  enum ring_buf_wait_kind kind;
+  /*!
+   * \brief Spin budget in polls.
+   * \details The adaptive strategy treats the budget as its upper limit.
+   */
+  unsigned spins;
+  /*!
+   * \brief Moving average of polls per wait, scaled by 16.
+   */
+  unsigned average;
+  void (*yield)(void *context);
+  void (*park)(void *context);
+  void *context;
+};
+
+/*!
+ * \brief Initialises a wait strategy without hooks.
+ */
+void ring_buf_wait_init(struct ring_buf_wait *wait,
+                        enum ring_buf_wait_kind kind, unsigned spins);
+
+/*!
+ * \brief Hints to the processor that the caller spins.
+ * \details Also acts as a compiler barrier so that polling re-reads the ring
+ * buffer's zones.
+ */
+void ring_buf_wait_pause(void);
+
+/*!
+ * \brief Relaxes once between polls of some other condition.
+ * \details Applies the strategy to conditions other than used or free space,
+ * pausing, yielding or parking according to the number of polls so far.
+ * \param polls Number of unsuccessful polls so far.
+ */
+void ring_buf_wait_idle(struct ring_buf_wait *wait, unsigned polls);
+
+/*!
+ * \brief Waits until the ring buffer holds at least \c size bytes.
+ * \retval 0 when ready to get.
+ * \retval -EMSGSIZE if \c size exceeds the ring buffer's entire size.
+ */
+int ring_buf_wait_get(const struct ring_buf *buf, struct ring_buf_wait *wait,
+                      ring_buf_size_t size);
+
+/*!
+ * \brief Waits until the ring buffer has room for at least \c size bytes.
+ * \retval 0 when ready to put.
+ * \retval -EMSGSIZE if \c size exceeds the ring buffer's entire size.
+ */
+int ring_buf_wait_put(const struct ring_buf *buf, struct ring_buf_wait *wait,
+                      ring_buf_size_t size);
+
+/*!
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,65 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ring_buf_wait.h"
+
+RING_BUF_DEFINE(buf, sizeof(float[4U]));
+
+static unsigned relaxes;
+
+/*
+ * Simulates the other side acknowledging a put after some number of yields or
+ * parks.
+ */
+static void relax_put(void *context) {
+  if (++relaxes == *(unsigned *)context) {
+    float number = 1.0F;
+    assert(ring_buf_put_all(&buf, &number, sizeof(number)) == 0);
+  }
+}
+
+int ring_buf_wait_test(int argc, char **argv) {
+  struct ring_buf_wait wait;
+  unsigned after = 3U;
+
+  ring_buf_wait_init(&wait, RING_BUF_WAIT_SPIN, RING_BUF_WAIT_SPINS);
+  assert(ring_buf_wait_get(&buf, &wait, sizeof(float[5U])) == -EMSGSIZE);
+  assert(ring_buf_wait_put(&buf, &wait, sizeof(float[4U])) == 0);
+
+  ring_buf_wait_init(&wait, RING_BUF_WAIT_YIELD, 10U);
+  wait.yield = relax_put;
+  wait.context = &after;
+  assert(ring_buf_wait_get(&buf, &wait, sizeof(float)) == 0);
+  assert(relaxes == 3U);
+  assert(ring_buf_get_all(&buf, NULL, sizeof(float)) == 0);
+
+  relaxes = 0U;
+  ring_buf_wait_init(&wait, RING_BUF_WAIT_PARK, 0U);
+  wait.park = relax_put;
+  wait.context = &after;
+  assert(ring_buf_wait_get(&buf, &wait, sizeof(float)) == 0);
+  assert(relaxes == 3U);
+  assert(ring_buf_wait_put(&buf, &wait, sizeof(float[3U])) == 0);
+  assert(ring_buf_get_all(&buf, NULL, sizeof(float)) == 0);
+
+  /*
+   * Long waits teach the adaptive strategy to park early.
+   */
+  ring_buf_wait_init(&wait, RING_BUF_WAIT_ADAPTIVE, 64U);
+  wait.park = relax_put;
+  wait.context = &after;
+  for (int i = 0; i < 32; i++) {
+    relaxes = 0U;
+    after = 1U;
+    assert(ring_buf_wait_get(&buf, &wait, sizeof(float)) == 0);
+    assert(ring_buf_get_all(&buf, NULL, sizeof(float)) == 0);
+  }
+  assert(wait.average >> 4U > 32U);
+  relaxes = 0U;
+  assert(ring_buf_wait_get(&buf, &wait, sizeof(float)) == 0);
+  assert(relaxes == 1U);
+  assert(ring_buf_get_all(&buf, NULL, sizeof(float)) == 0);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,58 @@
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "ring_buf_atomic.h"
+#include "ring_buf_wait.h"
+
+#define RECORDS 100000U
+
+RING_BUF_DEFINE(buf, sizeof(uint32_t[8U]));
+
+static void yield(void *context) {
+  (void)context;
+  (void)sched_yield();
+}
+
+/*
+ * Waits for room for each record, then puts it through a producer view.
+ */
+static void *produce(void *arg) {
+  struct ring_buf_wait wait;
+  (void)arg;
+  ring_buf_wait_init(&wait, RING_BUF_WAIT_YIELD, 100U);
+  wait.yield = yield;
+  for (uint32_t record = 0U; record < RECORDS; record++) {
+    assert(ring_buf_wait_put(&buf, &wait, sizeof(record)) == 0);
+    struct ring_buf view;
+    ring_buf_atomic_put_acquire(&view, &buf);
+    assert(ring_buf_put_all(&view, &record, sizeof(record)) == 0);
+    ring_buf_atomic_put_release(&buf, &view);
+  }
+  return NULL;
+}
+
+/*
+ * The producer and consumer wait for each other on separate threads. Every
+ * record must arrive, in order.
+ */
+int ring_buf_wait_thread_test(int argc, char **argv) {
+  pthread_t thread;
+  assert(pthread_create(&thread, NULL, produce, NULL) == 0);
+  struct ring_buf_wait wait;
+  ring_buf_wait_init(&wait, RING_BUF_WAIT_ADAPTIVE, 100U);
+  wait.park = yield;
+  for (uint32_t expect = 0U; expect < RECORDS; expect++) {
+    uint32_t record;
+    assert(ring_buf_wait_get(&buf, &wait, sizeof(record)) == 0);
+    struct ring_buf view;
+    ring_buf_atomic_get_acquire(&view, &buf);
+    assert(ring_buf_get_all(&view, &record, sizeof(record)) == 0);
+    ring_buf_atomic_get_release(&buf, &view);
+    assert(record == expect);
+  }
+  assert(pthread_join(thread, NULL) == 0);
+  return EXIT_SUCCESS;
+}